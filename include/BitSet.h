@@ -0,0 +1,49 @@
+#ifndef BITSET_H
+#define BITSET_H
+#include <vector>
+#include <stdint.h>
+#include <bits/stdc++.h>
+using namespace std;
+
+//Word-packed bitset kernels, 256 bits at a time when the CPU has AVX2 (checked once at startup,
+//no build flag needed) and one word at a time otherwise. n is always a number of 64 bit words.
+void orWords(uint64_t *dst, const uint64_t *src, size_t n);
+void andWords(uint64_t *dst, const uint64_t *src, size_t n);
+void xorWords(uint64_t *dst, const uint64_t *src, size_t n);
+size_t popcountWords(const uint64_t *a, size_t n);
+size_t popcountAnd(const uint64_t *a, const uint64_t *b, size_t n); //bits set in both a and b
+
+//lowest set bit at or above from, -1 if none
+int nextBit(const uint64_t *a, size_t n, int from);
+
+inline size_t bitWords(size_t nbits) {return (nbits + 63) / 64;}
+inline void setBit(uint64_t *a, int i) {a[i >> 6] |= 1ULL << (i & 63);}
+inline void clearBit(uint64_t *a, int i) {a[i >> 6] &= ~(1ULL << (i & 63));}
+inline bool testBit(const uint64_t *a, int i) {return (a[i >> 6] >> (i & 63)) & 1;}
+
+//rows x cols bits, every row starts on a word so rows can be handed to the kernels
+class BitMatrix {
+	private:
+		size_t W = 0; //words per row
+		vector<uint64_t> bits;
+
+	public:
+		BitMatrix() {}
+		BitMatrix(int rows, int cols) {assign(rows, cols);}
+
+		//all bits cleared, storage is kept when the shape does not grow
+		void assign(int rows, int cols) {
+			W = bitWords(cols);
+			bits.assign((size_t)rows * W, 0);
+		}
+
+		size_t rowWords() const {return W;}
+		uint64_t *row(int r) {return bits.data() + (size_t)r * W;}
+		const uint64_t *row(int r) const {return bits.data() + (size_t)r * W;}
+
+		void set(int r, int c) {setBit(row(r), c);}
+		void reset(int r, int c) {clearBit(row(r), c);}
+		bool test(int r, int c) const {return testBit(row(r), c);}
+		size_t count(int r) const {return popcountWords(row(r), W);}
+};
+#endif
@@ -9,12 +9,24 @@
 #include "GraphUtils.h"
 #define STRIDE_MIN 8
 using namespace std;
+
+//Timing analysis of a DFG in cycles. Every vertex takes the latency of its opcode from
+//nodeWts: the label up to ';' or ']' in lower case, LOD and STR read as load and store, "default"
+//for opcodes not in the table. Lower case load;s and store;s labels carry the access stride s
+//(upper case LOD;g and STR;g carry a group instead), accesses with s >= STRIDE_MIN take the
+//load_strided/store_strided latency. A latency table file (the drivers' -latency) holds
+//"<opcode> <cycles>" lines, # for comments, that override entries of the table. Latencies are at
+//least one cycle.
+typedef map<string, int> LatencyTable; //opcode overrides, read once by a driver and handed on
+
 class DFGAnaly {
 	private:
 		DAG gp;
 		map<string, int> nodeWts = {
 			{"load", 1},
 			{"store", 1},
+			{"load_strided", 1},
+			{"store_strided", 1},
 			{"fcmp", 1},
 			{"br", 1},
 			{"phi", 1},
@@ -29,18 +41,41 @@ class DFGAnaly {
 			{"fmul", 1},
 			{"fdiv", 1},
 			{"call_max", 1},
-			{"call_min", 1}
+			{"call_min", 1},
+			{"default", 1}
 		};
+		bool tableSet = false; //nodeWts was changed from the built in table
+		vector<int> lat; //latency of every vertex, empty until latencies() is called
+		vector<vector<int>> succs; //unique successors, empty until buildOrder() is called
+		vector<int> order; //topological order of the vertices, from buildOrder()
 
+		void buildOrder();
 
 	public:
 		DFGAnaly(DAG grph);
 		DFGAnaly();
 		void topoSortHelper(uint32_t node, vector<bool> &visited, stack<uint32_t> &st);
 		vector<uint32_t> topoSort();
+		//finish cycle of every vertex in topOrder, returns the largest
 		uint32_t assignTime(vector<uint32_t> &topOrder, vector<int32_t> &timeSt);
-		double getParallelism();
+		double getParallelism(); //vertices per cycle of the critical path
 		uint32_t criticalPathLen();
 		void getBasicProps();
+
+		//read "<opcode> <cycles>" lines, cycles at least 1; returns false if fname cannot be read,
+		//throws a string on a bad line
+		static bool readLatencyTable(const string &fname, LatencyTable &table);
+		void setLatencies(const LatencyTable &table);
+		void setLatency(const string &op, int cycles);
+		int opLatency(const string &label) const;
+		const vector<int> &latencies(); //latency of every vertex
+		string latencyTag() const; //"" for the built in table, otherwise a hash of the table
+
+		//earliest start cycle of every vertex, returns the schedule length
+		int asap(vector<int> &start);
+		//latest start cycle of every vertex in a schedule of the given length
+		void alap(int length, vector<int> &start);
+		//cycles every vertex can be delayed without stretching the ASAP schedule, returns its length
+		int slack(vector<int> &sl);
 };
 #endif
@@ -0,0 +1,37 @@
+#ifndef DFGCOARSEN_H
+#define DFGCOARSEN_H
+#include <vector>
+#include <string>
+#include <bits/stdc++.h>
+#include "Graph.h"
+using namespace std;
+
+//Contracts chains and small fan-in trees of a DFG into weighted super nodes before the ILP.
+//A vertex is merged into the cluster of its successor when that successor is the only one it
+//has, so every cluster is an in-tree whose root alone produces values used outside of it:
+//the coarse graph stays acyclic and its reads/writes are those of the original graph.
+//Load and store nodes are never merged to keep their group transactions intact.
+class DFGCoarsen {
+	private:
+		DAG gp;
+		DAG coarse;
+		int numVertices;
+		int maxWeight; //largest cluster allowed
+		vector<int> clusterOf; //coarse vertex of each original vertex
+		vector<int> weight; //original vertices in each coarse vertex
+
+	public:
+		DFGCoarsen(DAG &grph, int maxwt);
+
+		//returns the number of coarse vertices
+		int coarsen();
+
+		DAG &getOrigGraph() {return gp;}
+		DAG &getCoarseGraph() {return coarse;}
+		const vector<int> &getWeights() const {return weight;}
+		int getClusterOf(int v) const {return clusterOf[v];}
+
+		//partition of every original vertex from the partition of every coarse vertex
+		vector<int> expand(const vector<int> &coarsePart) const;
+};
+#endif
@@ -0,0 +1,69 @@
+#ifndef DFGDECOMP_H
+#define DFGDECOMP_H
+#include <vector>
+#include <string>
+#include <functional>
+#include <bits/stdc++.h>
+#include "Graph.h"
+#include "PartEval.h"
+using namespace std;
+
+//one independently solvable piece of a DFG
+typedef struct SubProblem {
+	DAG graph; //piece with ids 0..n-1, boundary pseudo nodes come after the real vertices
+	vector<int> origIds; //original id of each real vertex of the piece
+	int numReal = 0; //number of real vertices, the rest are boundary pseudo nodes
+	vector<vector<int>> bndReads; //windowed and pipelined pieces: consumers of each value produced before the piece
+	vector<int> bndWrites; //windowed pieces: vertices whose value is consumed beyond the window
+	int prevReads = 0; //windowed pieces: reads of the partition before the window, see PartModel::setBoundary
+	string label; //"piece<p>" or "window<n>", names what is written per piece
+	vector<int> part; //solution: partition of every vertex of graph
+	int numParts = 0;
+	bool solved = false;
+} SubProblem;
+
+//solver for a piece, fills part and numParts and returns true on success
+typedef function<bool(SubProblem &)> SubSolver;
+
+//Splits a DFG into weakly connected components and, inside a component, at articulation
+//vertices that are crossed by at most cutMax values all flowing the same way. Values crossing
+//a cut are modelled in the pieces as pseudo load/store nodes of fresh groups, so each piece
+//is a plain DFG whose transaction counts bound the real ones. Pipelined, values entering a
+//piece are boundary reads instead (SubProblem::bndReads) as pseudo loads would be prefetched.
+//Pieces are solved concurrently and their ordered partitions are overlaid into one assignment
+//of the whole graph.
+class DFGDecomp {
+	private:
+		DAG gp;
+		int numVertices;
+		int cutMax; //most values allowed to cross an articulation cut
+		int minPiece; //smallest piece worth solving separately
+		bool pipelined = false; //values entering a piece are boundary reads, see setPipelined
+		vector<vector<int>> succs, preds; //unique neighbours
+		vector<vector<int>> pieces; //vertices of each piece
+		vector<int> pieceOf; //piece of each vertex
+		vector<SubProblem> subs;
+
+		void splitPiece(vector<int> &verts);
+		bool findCut(const vector<int> &verts, vector<int> &cutSide);
+		void buildSub(int p, int &nextGroup);
+
+	public:
+		DFGDecomp(DAG &grph, int cutmax = 2, int minpiece = 8);
+
+		//pieces for the pipelined read budget of partLimits, before decompose
+		void setPipelined(bool p) {pipelined = p;}
+
+		//returns the number of pieces
+		int decompose();
+		vector<SubProblem> &getSubProblems() {return subs;}
+
+		//solve all pieces on nThreads threads (0 for one per core), returns false if any piece failed
+		bool solveAll(SubSolver solver, int nThreads);
+
+		//overlay piece solutions in dependence order, packing pieces into shared partitions when
+		//capacity, FU class, scratchpad and transaction limits allow, the pipelined read budget of
+		//eval's limits included; returns the partition count or -1 on failure
+		int merge(PartEval &eval, vector<int> &part);
+};
+#endif
@@ -0,0 +1,65 @@
+#ifndef DFGGEN_H
+#define DFGGEN_H
+#include <vector>
+#include <string>
+#include <random>
+#include <bits/stdc++.h>
+#include "Graph.h"
+using namespace std;
+
+//Synthetic DFGs in the dialect of the bundled kernels (LOD;group / STR;group memory nodes, upper
+//case ops, dense ids) for scaling runs well past the size of the corpus. Every shape appends a
+//disjoint component, so shapes can be mixed in one graph. Graphs are kept as flat arrays and
+//written to DOT directly since the Graph classes are not meant for 10^5+ nodes; toDAG builds one
+//for sizes they can handle. The same seed and calls give the same graph on every platform.
+class DFGGen {
+	private:
+		vector<string> labels;
+		vector<pair<int, int>> edges;
+		mt19937 rng;
+		int groupSize; //memory nodes sharing a load/store group
+		int nextGroup = 0; //group ids are unique across loads and stores
+		int loadGroup = -1, loadFill = 0; //group being filled by loads and its members so far
+		int storeGroup = -1, storeFill = 0;
+
+		int rand(int n) {return rng() % n;} //not uniform_int_distribution, it differs between libraries
+		string randOp();
+		int addNode(const string &lbl);
+		void addEdge(int src, int dst) {edges.push_back({src, dst});}
+		int addLoad();
+		int addStore(int src);
+		void closeGroups(); //the next memory nodes start new groups
+		int sum(vector<int> vals, int arity); //ADD tree over vals, returns its root
+
+	public:
+		DFGGen(unsigned seed = 1, int grpSize = 4);
+
+		//layers of width nodes, each taking fanin operands from the previous layer or, with
+		//probability skipPct percent, from any earlier one; loads feed the first layer
+		void layered(int layers, int width, int fanin, int skipPct = 10);
+
+		//radix-2 FFT of 2^logn points, a MUL, ADD and SUB per butterfly
+		void fft(int logn);
+
+		//5-point stencil over a width x height grid applied steps times, loads by row
+		void stencil(int width, int height, int steps);
+
+		//reduction of n loaded values with ADD trees of the given arity
+		void reduce(int n, int arity);
+
+		//m x k times k x n matrix tile, one MUL per product and an ADD tree per output
+		void matmul(int m, int n, int k);
+
+		//copies of an existing kernel, LOD;g/STR;g groups renumbered per copy, load;s/store;s strides kept
+		void replicate(DAG &kernel, int copies);
+
+		//every value nobody consumes gets a store, as the kernels in the corpus do
+		void storeSinks();
+
+		int getNumNodes() const {return labels.size();}
+		int getNumEdges() const {return edges.size();}
+
+		void write(const string &fname) const;
+		DAG toDAG() const;
+};
+#endif
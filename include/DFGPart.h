@@ -6,9 +6,13 @@
 #include <bits/stdc++.h>
 #include <string>
 #include "Graph.h"
+#include "BitSet.h"
+#include "PartLimits.h"
+#include "PerfModel.h"
 typedef struct partData {
 	int total;
 	int out;
+	int resident; //values of earlier steps still needed, held in the scratchpad
 }partData;
 
 typedef struct partDef {
@@ -20,13 +24,35 @@ typedef struct partDef {
 class DFGPart {
 	private: 
 		DAG gp;
+		vector<int> assign; //partition of every vertex in the chosen partitioning
+		BitMatrix upTo; //row t: vertices with time <= t
+		BitMatrix live; //row t: vertices with time <= t and a successor after t
+		FUClasses fu;
+		BitMatrix classMasks; //row c: vertices of FU class c, only with class capacities
+		int SPSize; //scratchpad slots, INT_MAX without a cap
+		LatencyTable latTable; //overrides of the DFGAnaly latencies the levels are timed with
+		PerfModel *perf = NULL; //time objective, NULL to minimize intermediate outputs
+		//partition of every vertex of the steps covered by parts
+		vector<int> assignOf(const vector<partDef> &parts, vector<int32_t> &timeSt);
+		void levelMasks(vector<int32_t> &timeSt, int timeMax);
+		//vertices with time in start..end stay within every FU class capacity
+		bool fitsClasses(int start, int end);
 
 	public:
-	DFGPart(DAG grph);
+	//the FU classes and scratchpad cap of lim apply to every partition, the capacity is the
+	//map_size of each call and transactions are not limited; latencies overrides the opcode
+	//latencies, see DFGAnaly
+	DFGPart(DAG grph, const partLimits &lim = partLimits(), const LatencyTable &latencies = LatencyTable());
 	vector<vector<int>> getCombs(int timeMax, int k);
+	//vertices with time in start..end, those of them used after end and the values from before
+	//start used from start on, from the masks of timeSt
 	partData getInterNds(int start, int end, vector<int32_t> &timeSt);
 	int partitionDFGnP(int npart, int map_size);
-	void partitionDFGVar(int map_size);
+	int partitionDFGVar(int map_size);
+	const vector<int> &getAssign() const {return assign;}
+	//choose among the valid splits by the estimated cycles per invocation of pm, NULL for the
+	//intermediate outputs; pm is not owned
+	void setObjective(PerfModel *pm) {perf = pm;}
 	void getBasicProfs();
 	int printParts(vector<partDef>& AllParts);
 };
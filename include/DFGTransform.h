@@ -0,0 +1,40 @@
+#ifndef DFGTRANSFORM_H
+#define DFGTRANSFORM_H
+#include <vector>
+#include <string>
+#include <bits/stdc++.h>
+#include "Graph.h"
+using namespace std;
+
+//Graph to graph rewrites of the preprocessing flow, working on an in-memory DAG so they can be
+//chained without writing DOT in between. The analysis of each runs in O(V + E) over flat arrays
+//built once from the node and edge lists, and the result is built from flat arrays in one go at
+//the end. That build goes through DAG::addNode/addEdge, which check every id against the graph
+//so far, so it is quadratic and dominates on large graphs. Node ids of the input may be sparse,
+//the output ids are 0..V'-1 in the order of the input node list.
+
+//read a DOT file in the raw exporter dialect (any node names, "n [label = OP ...]" nodes) into a
+//DAG with ids 0..V-1 in file order, the parser dotconv1 writes converted files with
+DAG convertDOT(const string &fname);
+
+//same graph with ids 0..V-1 in node list order
+DAG normalize(DAG &dfg);
+
+//drop every node whose value reaches no store; graphs without stores are returned unchanged
+DAG eliminateDead(DAG &dfg);
+
+//drop every node computing the address of a load (all ancestors of LOD nodes) and the edges
+//touching them
+DAG loadSanitize(DAG &dfg);
+
+//renumber the nodes so neighbours get nearby ids, edges come out sorted by source:
+//  "bfs"   topological order taken breadth first, values and their consumers end up close
+//  "level" ASAP level major, ties broken by the bfs order
+//  "rcm"   reverse Cuthill-McKee on the undirected graph, smallest bandwidth, not topological
+//origId[v] is the input id of new node v; throws on an unknown order
+DAG renumber(DAG &dfg, const string &order, vector<int> &origId);
+
+//per vertex values of a renumbered graph (e.g. a partition assignment) in input id order, for
+//inputs with ids 0..V-1 as the partitioners expect; unchanged if origId is empty
+vector<int> restoreOrder(const vector<int> &vals, const vector<int> &origId);
+#endif
@@ -4,5 +4,26 @@
 #include <iostream>
 #include <tuple>
 #include <map>
+#include <string>
+#include <vector>
 using namespace std;
+
+//load nodes are labelled either load;group or LOD;group, stores either store;group or STR;group
+bool isLoadOp(const string &op);
+bool isStoreOp(const string &op);
+
+//group id placed after ";" in a load/store label
+int getMemGroup(const string &op);
+
+//opcode of a label: the text before ';' or ']' in lower case, LOD and STR as load and store
+string opcodeOf(const string &label);
+
+//FNV-1a: h starts at FNV_OFFSET, stable across builds so it can key files on disk
+const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+void hashBytes(uint64_t &h, const void *data, size_t len);
+uint64_t hashString(const string &s);
+
+//dot files named by a corpus entry: a dot file, a directory of dot files (sorted) or a text file
+//listing one dot file per line, # starting a comment line
+void collectDotFiles(const string &entry, vector<string> &files);
 #endif
@@ -0,0 +1,45 @@
+#ifndef FUCLASSES_H
+#define FUCLASSES_H
+#include <vector>
+#include <string>
+#include <bits/stdc++.h>
+#include "Graph.h"
+using namespace std;
+
+class DFGCoarsen;
+
+//Functional unit classes of a heterogeneous CGRA: every opcode (see opcodeOf) runs on the
+//cells of one class and a partition holds at most the capacity of each class, on top of the
+//RSize limit on all vertices. Opcodes not listed go to the first class, "any", of unlimited
+//capacity, so without classes only RSize applies. The drivers load a file of
+//"<class> <capacity> <opcode>..." lines, # for comments, given with -fu and hand it to the
+//partitioners; a default constructed FUClasses has only "any".
+//Class usage of a graph is laid out vertex major, numClasses() entries per vertex, so the
+//vertices of a coarsened graph can use several classes.
+class FUClasses {
+	private:
+		vector<string> names;
+		vector<int> capacity;
+		map<string, int> classOfOp;
+
+	public:
+		FUClasses();
+
+		//read class lines from fname; returns false if it cannot be read, throws a string on a bad line
+		bool load(const string &fname);
+		void addClass(const string &name, int cap, const vector<string> &ops);
+
+		int numClasses() const {return names.size();}
+		const string &getName(int c) const {return names[c];}
+		int getCapacity(int c) const {return capacity[c];}
+		bool limited() const; //some class has a capacity
+		string tag() const; //"" without classes, otherwise a hash of the classes
+
+		int classOf(const string &label) const;
+		vector<int> usage(DAG &gp) const; //one class per vertex
+		vector<int> usage(DFGCoarsen &cr) const; //summed over the members of each coarse vertex
+
+		//"" if every partition of part fits the class capacities, otherwise the first violation
+		string check(const vector<int> &use, const vector<int> &part, int numParts) const;
+};
+#endif
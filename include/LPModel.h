@@ -0,0 +1,75 @@
+#ifndef LPMODEL_H
+#define LPMODEL_H
+#include <vector>
+#include <string>
+#include <bits/stdc++.h>
+using namespace std;
+
+#define LP_INF 1e30 //bound value treated as infinite by the writers and loaders
+
+//Solver independent description of a linear (0-1) program.
+//Columns are kept in flat arrays and rows in compressed sparse row form so that
+//models can be dumped to CPLEX-LP / free-MPS text or loaded into a solver
+//without building an intermediate solver object.
+class LPModel {
+	private:
+		string name;
+
+		//columns
+		vector<string> colName;
+		vector<double> colObj;
+		vector<double> colLo;
+		vector<double> colHi;
+		vector<char> colBin; //1 if column is binary
+
+		//rows, coefficients of row r are at rowBeg[r]..rowBeg[r + 1] - 1
+		vector<string> rowName;
+		vector<double> rowLo;
+		vector<double> rowHi;
+		vector<int> rowBeg;
+		vector<int> rowInd;
+		vector<double> rowVal;
+
+		void writeLPStream(void *out);
+		void writeMPSStream(void *out);
+
+	public:
+		LPModel(string nm = "lp");
+		void clear();
+
+		//add a column and return its index (0 based)
+		int addCol(string nm, double obj, double lo, double hi, bool bin);
+		int addBinCol(string nm, double obj = 0);
+		void setObj(int col, double val);
+		//fix a column to val; a fixed binary becomes a continuous column with equal bounds since
+		//the writers give binaries no bounds of their own
+		void fixCol(int col, double val);
+
+		//rows can be built incrementally: beginRow followed by addCoef calls
+		int beginRow(string nm, double lo, double hi);
+		void addCoef(int col, double val);
+		int addRow(string nm, double lo, double hi, const vector<int> &ind, const vector<double> &val);
+
+		string getName() const {return name;}
+		int getNumCols() const {return colObj.size();}
+		int getNumRows() const {return rowLo.size();}
+		long getNumNZ() const {return rowInd.size();}
+		string getColName(int c) const;
+		string getRowName(int r) const;
+		double getObj(int c) const {return colObj[c];}
+		double getColLo(int c) const {return colLo[c];}
+		double getColHi(int c) const {return colHi[c];}
+		bool isBinary(int c) const {return colBin[c];}
+		double getRowLo(int r) const {return rowLo[r];}
+		double getRowHi(int r) const {return rowHi[r];}
+		int getRowBeg(int r) const {return rowBeg[r];}
+		int getRowEnd(int r) const {return rowBeg[r + 1];}
+		int getInd(int k) const {return rowInd[k];}
+		double getVal(int k) const {return rowVal[k];}
+
+		//write model; format picked from extension (.lp or .mps), a trailing .gz compresses output
+		void write(string fname);
+		void writeLP(string fname, bool gz = false);
+		void writeMPS(string fname, bool gz = false);
+};
+#endif
@@ -0,0 +1,108 @@
+#ifndef PARTBNB_H
+#define PARTBNB_H
+#include <vector>
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <bits/stdc++.h>
+#include "Graph.h"
+#include "BitSet.h"
+#include "PartLimits.h"
+using namespace std;
+
+//Branch and bound for the ordered partitioning problem with a fixed partition count.
+//Vertices are assigned in topological order, each to a partition no earlier than its
+//predecessors', so every partial assignment is precedence feasible. Sizes, reads, writes and
+//load/store group transactions are updated incrementally on assign/undo, with the costs of
+//PartEval: a write per value leaving its partition, a read per distinct later partition using
+//it, a transaction per load/store group present in a partition. FU class capacities (see
+//FUClasses) are checked alongside RSize, scratchpad occupancy (see ScratchPad) against SPSize.
+//Threads work on disjoint subtrees below a shared frontier and share the incumbent.
+class PartBnB {
+	private:
+		//search state of one thread
+		typedef struct BnBState {
+			vector<int> part; //-1 while unassigned
+			vector<int> size, reads, writes, loads, stores; //per partition
+			vector<int> useCnt; //consumers of value u in partition p, at u * numParts + p
+			BitMatrix useMask; //partitions reading value u, the nonzero entries of useCnt
+			vector<int> laterCnt; //distinct later partitions using value u
+			vector<int> grpCnt; //members of group g in partition p, at g * numParts + p
+			vector<int> grpAssigned; //assigned members of group g
+			vector<int> classCnt; //FU class c used in partition p, at p * numClasses + c
+			vector<int> lastUse; //last partition reading value u, -1 if none after its own
+			vector<int> resident; //values in the scratchpad while partition p runs
+			int unstarted = 0; //groups with no assigned member
+			int maxUsed = -1; //highest partition holding a vertex
+			long cost = 0;
+			long nodes = 0;
+			long budget = LONG_MAX; //nodes this state may visit
+			vector<int> lb, bucket, freeGe; //scratch for the bound
+			vector<long> mark; //values already counted by the bound, stamped with markStamp
+			long markStamp = 0;
+		} BnBState;
+
+		int numVertices;
+		int numGroups;
+		int numParts = 0;
+		vector<vector<int>> succs, preds; //unique neighbours
+		vector<int> order; //topological order in which vertices are assigned
+		vector<int> memGroup; //dense load/store group of each vertex, -1 if none
+		vector<char> grpStore; //1 if the group is a store group
+		vector<int> weight; //capacity each vertex takes, original vertices behind a coarse one
+		vector<int> nAnc, nDesc; //ancestor and descendant counts of each vertex
+		int numClasses = 0; //FU classes, 0 without class capacities
+		vector<int> classUse, classCap; //usage of each vertex, vertex major, and class capacities
+
+		int nThreads = 1;
+		double timeLimit = 0; //seconds, 0 for none
+		long nodeLimit = 0; //search nodes per solve, 0 for none
+		chrono::steady_clock::time_point deadline;
+
+		atomic<long> bestCost;
+		vector<int> bestPart;
+		mutex bestMtx;
+		atomic<bool> stopped; //time limit hit, search incomplete
+		atomic<long> totalNodes;
+
+		//partitions v can take at all: it and its ancestors fill the earlier ones, it and its
+		//descendants the later ones
+		int winLo(int v) const {return (nAnc[v] + weight[v] + RSize - 1) / RSize - 1;}
+		int winHi(int v) const {return numParts - (nDesc[v] + weight[v] + RSize - 1) / RSize;}
+
+		void initState(BnBState &s);
+		void apply(BnBState &s, int v, int p);
+		void undo(BnBState &s, int v);
+		bool feasibleAfter(BnBState &s, int v);
+		long bound(BnBState &s, int d);
+		void candidates(BnBState &s, int d, vector<pair<long, int>> &cand);
+		void offer(BnBState &s);
+		void dfs(BnBState &s, int d);
+		void dive(BnBState &s);
+
+	public:
+		int RSize; //capacity of a partition
+		int TSize; //transaction limit
+		int loadWeight; //weight for load/store transactions
+		int writeWeight = 1; //weight for intermediate writes
+		int SPSize; //scratchpad slots, INT_MAX without a cap
+		bool hoistLoads; //pipelined mode: the loads of p + 1 take the read budget of p
+
+		PartBnB(DAG &gp, const partLimits &lim);
+
+		void setThreads(int n) {nThreads = n;}
+		void setTimeLimit(double secs) {timeLimit = secs;}
+		void setNodeLimit(long n) {nodeLimit = n;} //checked every 4096 nodes of a thread
+		void setWeights(const vector<int> &wts) {weight = wts;} //for coarsened graphs, see DFGCoarsen
+		//FU class usage of coarsened vertices, see FUClasses::usage; ignored without class capacities
+		void setClassUsage(const vector<int> &use) {if(numClasses > 0) classUse = use;}
+
+		//best assignment to at most numParts ordered partitions; returns false if none was found
+		bool solve(int nParts, vector<int> &part);
+
+		long getBestCost() const {return bestCost;}
+		bool isOptimal() const {return !stopped;} //search finished within the time limit
+		long getNodes() const {return totalNodes;}
+};
+#endif
@@ -0,0 +1,35 @@
+#ifndef PARTCACHE_H
+#define PARTCACHE_H
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include <bits/stdc++.h>
+#include "Graph.h"
+#include "PartLimits.h"
+using namespace std;
+
+//Structural hash of a DFG that does not depend on vertex numbering: colour refinement over
+//labels, predecessors, successors and load/store group mates. canon gets the vertices in
+//canonical order (by final colour, ties by id) so assignments can be moved between numberings.
+uint64_t canonicalHash(DAG &gp, vector<int> &canon);
+
+//On-disk cache of partition assignments keyed by canonical hash, partitioner and parameters.
+//Entries are .part files (see PartResult.h) holding the canonical hash and the assignment in
+//canonical order. A hit is mapped back to the caller's numbering and revalidated with PartEval
+//so graphs that only look alike to the hash are treated as misses.
+class PartCache {
+	private:
+		string dir;
+		string entryName(uint64_t hash, const string &solver, const partLimits &lim);
+
+	public:
+		//dir defaults to $DFG_PART_CACHE or .partcache
+		PartCache(const string &cacheDir = "");
+
+		//solver names the partitioner and mode, e.g. "cplex" or "dfgpart"; entries are named by
+		//RSize, TSize and loadWeight of lim. Returns true and fills part/numParts on a hit valid
+		//under all of lim (see PartEval).
+		bool lookup(DAG &gp, const string &solver, const partLimits &lim, vector<int> &part, int &numParts);
+		void store(DAG &gp, const string &solver, const partLimits &lim, const vector<int> &part, int numParts);
+};
+#endif
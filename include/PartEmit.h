@@ -0,0 +1,36 @@
+#ifndef PARTEMIT_H
+#define PARTEMIT_H
+#include <vector>
+#include <string>
+#include <bits/stdc++.h>
+#include "Graph.h"
+using namespace std;
+
+//Writes the sub-DFG of every partition of an ordered partitioning, the input of the CGRA mapper.
+//Vertices keep their labels and are renumbered in original id order; every edge leaving the
+//partition ends in a fresh sc_pad_write node and every edge entering it starts at a fresh
+//sc_pad_read node, both added after the vertices in edge order. Vertices and edges are bucketed
+//by partition in a single pass over the graph and the partition files are written concurrently.
+//
+//Binary files (.bin) hold the same graph, all integers are 32 bit little endian:
+//  "DFGP" version nodes edges, nodes x (labelLen label), edges x (src dst labelLen label)
+class PartEmitter {
+	private:
+		vector<string> labels; //label of each vertex
+		vector<int> edgeSrc, edgeDst;
+		vector<string> edgeLabel;
+
+		void writeDOT(const string &fname, const vector<int> &verts, const vector<pair<int, char>> &edges, const vector<int> &local);
+		void writeBinary(const string &fname, const vector<int> &verts, const vector<pair<int, char>> &edges, const vector<int> &local);
+
+	public:
+		PartEmitter(DAG &gp);
+
+		//write dir/<p>.dot (or dir/<p>.bin) for every partition using nThreads threads (0 for one
+		//per core); returns the number of files written
+		int emit(const vector<int> &part, int numParts, const string &dir, bool binary = false, int nThreads = 0);
+};
+
+//outputParts/<graph file name without .dot>_<RSize>_<TSize>_<loadWeight>/
+string partsDir(const string &graphName, int RSize, int TSize, int loadWeight);
+#endif
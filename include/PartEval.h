@@ -0,0 +1,62 @@
+#ifndef PARTEVAL_H
+#define PARTEVAL_H
+#include <vector>
+#include <string>
+#include <bits/stdc++.h>
+#include "Graph.h"
+#include "BitSet.h"
+#include "PartLimits.h"
+using namespace std;
+
+//size and transaction counts of one partition
+typedef struct partCounts {
+	int size; //vertices mapped to the partition
+	int reads; //values read from earlier partitions
+	int writes; //values written for later partitions
+	int inEdges; //edges coming from earlier partitions
+	int outEdges; //edges going to later partitions
+	int loads; //load group transactions
+	int stores; //store group transactions
+	int resident; //values held in the scratchpad while it runs, see ScratchPad
+} partCounts;
+
+//Checks and costs an ordered partition assignment (vertex -> partition id) of a DFG.
+//The graph is copied once into flat arrays so every evaluation is a single O(V + E) pass.
+//Reads and writes come from a row of partition bits per vertex marking where its successors
+//are, transactions from a row of group bits per partition counted against the load and store
+//group masks. Vertex ids are expected to be 0..V-1 as everywhere else in the partitioners.
+class PartEval {
+	private:
+		int numVertices;
+		vector<int> edgeSrc, edgeDst; //every edge, parallel edges included
+		vector<int> succBeg, succList; //unique successors of each vertex in CSR form
+		vector<char> grpStore; //1 if the group is a store group
+		vector<int> memGroup; //dense load/store group of each vertex, -1 if none
+		vector<uint64_t> loadMask, storeMask; //load and store groups as group bits
+		BitMatrix succParts; //partitions holding successors of v, scratch of validate
+		BitMatrix partGroups; //groups present in partition p, scratch of validate
+		partLimits lim;
+		vector<int> fuUse; //class usage of every vertex, empty without class capacities
+
+	public:
+		int writeWeight = 1; //weight for intermediate writes
+
+		PartEval(DAG &gp, const partLimits &limits);
+
+		int getNumVertices() const {return numVertices;}
+		int getNumGroups() const {return grpStore.size();}
+		int getGroupOf(int v) const {return memGroup[v];}
+		const partLimits &getLimits() const {return lim;}
+		const vector<int> &getClassUse() const {return fuUse;} //vertex major, empty without class capacities
+
+		//fill per partition counts; returns an empty string if the assignment is a valid
+		//ordered partitioning under the limits, otherwise the first violation found
+		string validate(const vector<int> &part, int numParts, vector<partCounts> &counts);
+
+		//objective of the partitioning ILP: weighted load/store transactions plus a write and a read
+		//for every (value, later partition) pair
+		long cost(const vector<partCounts> &counts) const;
+
+		void printCounts(const vector<partCounts> &counts) const;
+};
+#endif
@@ -0,0 +1,23 @@
+#ifndef PARTLIMITS_H
+#define PARTLIMITS_H
+#include <string>
+#include <bits/stdc++.h>
+#include "FUClasses.h"
+using namespace std;
+
+//What an ordered partitioning must fit and how it is costed, the same for every partitioner:
+//PartEval, PartBnB, PartModel, DFGPart and PartCache all take one partLimits so a new
+//constraint is a new field here rather than another argument on each of them. A default
+//constructed partLimits leaves everything open.
+typedef struct partLimits {
+	int RSize = INT_MAX; //vertices per partition
+	int TSize = INT_MAX; //read and write transactions per partition
+	int loadWeight = 1; //weight of a load/store group transaction in the cost
+	FUClasses fu; //capacity per FU class, see FUClasses; only the unlimited "any" by default
+	int spSize = INT_MAX; //values resident in the scratchpad while a partition runs, see ScratchPad
+	//double buffered execution (the drivers' -pipeline): the configuration and load groups of a
+	//partition are fetched while the one before it runs, so the load transactions of p + 1 count
+	//against the read budget of p and partition 0 prefetches its own (see PerfModel)
+	bool pipelined = false;
+} partLimits;
+#endif
@@ -0,0 +1,133 @@
+#ifndef PARTMODEL_H
+#define PARTMODEL_H
+#include <vector>
+#include <string>
+#include <bits/stdc++.h>
+#include "Graph.h"
+#include "LPModel.h"
+#include "PartLimits.h"
+using namespace std;
+
+//Builds the ordered partitioning 0-1 ILP of a DFG as a solver independent LPModel.
+//Xij     : vertex i mapped to partition j
+//lpg/lps : load/store group present in partition
+//Xikl    : vertex i in partition k has a successor in partition l (k < l), costs a write and a read
+//Yikl    : some successor of vertex i is mapped to partition l
+//Rbl     : boundary value b coming from before the model is read in partition l
+//Sil     : value of vertex i is in the scratchpad while partition l runs, only under a scratchpad cap
+class PartModel {
+	private:
+	DAG graph;
+	LPModel lp;
+
+	int nUniqCons = 0; //uniqness constraints rows count
+	int nCapCons = 0; //capacity contsraints rows count
+	int nPrecCons = 0; //precedence constraints rows count
+	int nIntParCons = 0; //inter partition constraints rows count
+	int nLdStCons = 0; //load/store constraints count
+	int nTransCons = 0; //Transaction constraints count
+
+	int nXij = 0; //number of assignment variables
+	int nLp = 0; //number of loadgroup variables
+	int nInPa = 0; //number of Xikl and Yikl variables
+
+	int numLoads = 0;// total number of loads
+	int numStores = 0; //total number of stores
+
+	int Vout = 0; //number of vertices having non-zero successors
+
+	int RSize; //capacity or size of a partition
+	int TSize; //transaction limit
+
+	int numVertices;
+	int numEdges;
+	int numParts;
+	int nPairs; //number of k < l partition pairs
+	int loadWeight = 1; //weight for load from memory
+	int writeWeight = 1; //weight for intermediate writes
+
+	int xBase = 0; //first Xij column, Xij columns are laid out vertex major
+	int inBase = 0; //first Xikl column, Xikl and Yikl interleaved per vertex and kl pair
+
+	map<int, vector<int>> loadGroups;
+	map<int, vector<int>> storeGroups;
+	map<int, vector<int>> lpgMap; //loadgroup_id->lp columns, one for each partition
+	map<int, vector<int>> lpsMap; //storegroup_id->lp columns, one for each partition
+	///Important assumption is that ids i.e keys are unique across lgpMap and lpsMap
+
+	vector<vector<int>> succs; //unique successor ids of each vertex
+
+	//values crossing the boundary of a windowed model
+	vector<vector<int>> bndReads; //consumers of each value produced before the model's partitions
+	vector<int> bndWrites; //vertices whose value is also consumed after the model's partitions
+	int bndPrefetch = 0; //reads of the partition before the model's, see setBoundary
+	int rBase = 0; //first Rbl column, one per boundary value b and partition l
+
+	vector<int> weights; //vertices of the original graph behind each vertex, empty if all 1
+	int SPSize; //scratchpad slots, INT_MAX without a cap
+	bool hoistLoads; //pipelined mode: read row k holds the load groups of k + 1, see PartEval
+	FUClasses fu;
+	vector<int> classUse; //FU class usage of each vertex, vertex major, empty without class capacities
+
+	bool prune = false; //fix Xij outside the partitions vertex i can reach, see setPrune
+	bool lazy = false; //leave inter partition and transaction rows out until a solution violates them
+	vector<char> pairRowDone; //Xikl/Yikl rows present for each vertex and kl pair
+	vector<char> readRowDone, writeRowDone; //transaction rows present for each partition
+
+	int pairIdx(int k, int l) const {return k * (2 * numParts - k - 1) / 2 + (l - k - 1);}
+	void addPairRows(int i, int k, int l);
+	void addReadRow(int k);
+	void addWriteRow(int k);
+
+	public:
+	//nPts partitions under lim, the scratchpad cap with addScratchCons
+	PartModel(DAG gp, int nPts, const partLimits &lim);
+
+	//model only part of a graph: bReads holds the consumers of each value produced before the first
+	//partition (read once per partition using it), bWrites the vertices read after the last one and
+	//prevReads the reads of the partition before the first, which prefetches its loads when pipelined
+	void setBoundary(const vector<vector<int>> &bReads, const vector<int> &bWrites, int prevReads);
+
+	//capacity weight of each vertex, for graphs coarsened into super nodes
+	void setWeights(const vector<int> &wts) {weights = wts;}
+	int getWeight(int v) const {return weights.empty() ? 1 : weights[v];}
+	//FU class usage of coarsened vertices, see FUClasses::usage; ignored without class capacities
+	void setClassUsage(const vector<int> &use) {if(!classUse.empty()) classUse = use;}
+
+	void addColVars();
+	void addUniqueCons();
+	void addSizeCons();
+	void addEdgePrec();
+	void addInterPartCons();
+	void addTransCons();
+	void addLoadStoreReuse();
+	//Sil and a row per partition keeping resident values within SPSize, nothing without a cap
+	void addScratchCons();
+	void printVarCons();
+
+	//fix Xij to 0 where partition j is too early for the ancestors of i or too late for its
+	//descendants to fit at RSize vertices per partition, set before building
+	void setPrune(bool p) {prune = p;}
+
+	//cutting plane mode, set before building: the model starts from uniqueness, capacity,
+	//precedence and load/store rows and separate() adds the inter partition rows of every value
+	//crossing partitions in part plus the transaction rows part violates. Returns the rows added,
+	//0 means part is optimal for the full model if it was optimal for the current one.
+	void setLazy(bool lz) {lazy = lz;}
+	bool isLazy() const {return lazy;}
+	int separate(const vector<int> &part);
+
+	LPModel &getLP() {return lp;}
+	int getNumParts() const {return numParts;}
+	int getNumVertices() const {return numVertices;}
+	int getLoadWeight() const {return loadWeight;}
+	const map<int, vector<int>> &getLoadGroups() const {return loadGroups;}
+	const map<int, vector<int>> &getStoreGroups() const {return storeGroups;}
+
+	//column indices of the model variables
+	int xij(int i, int j) const {return xBase + i * numParts + j;}
+	int xikl(int i, int k, int l) const {return inBase + 2 * (i * nPairs + pairIdx(k, l));}
+	int yikl(int i, int k, int l) const {return xikl(i, k, l) + 1;}
+	int rbl(int b, int l) const {return rBase + b * numParts + l;}
+};
+#endif
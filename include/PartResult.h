@@ -0,0 +1,43 @@
+#ifndef PARTRESULT_H
+#define PARTRESULT_H
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include <bits/stdc++.h>
+#include "Graph.h"
+#include "PartLimits.h"
+using namespace std;
+
+//Solver independent partition assignment, stored as a small text file:
+//  dfgpart 2
+//  graph <64 bit hash in hex> <vertices> <edges>
+//  limits <RSize> <TSize> <loadWeight>
+//  mode <serial|pipelined> spad <capacity|-> fu <FUClasses tag|->
+//  parts <numParts> cost <cost>
+//  followed by the partition of every vertex in id order, whitespace separated
+//Version 1 files have no mode line and are read as serial without scratchpad or FU limits.
+typedef struct PartResult {
+	uint64_t graphHash = 0;
+	int numVertices = 0;
+	int numEdges = 0;
+	int RSize = 0;
+	int TSize = 0;
+	int loadWeight = 1;
+	bool pipelined = false; //see partLimits
+	int spSize = INT_MAX;
+	string fuTag; //FUClasses::tag of the classes solved for, "" without
+	int numParts = 0;
+	long cost = -1; //as reported by the partitioner, -1 if unknown
+	vector<int> part;
+} PartResult;
+
+//hash of the vertex labels in id order and the sorted edge list, ties a result to its DFG
+uint64_t graphHash(DAG &gp);
+
+//result for an assignment of gp, costed with PartEval (-1 if the assignment is invalid under lim)
+PartResult makeResult(DAG &gp, const vector<int> &part, int numParts, const partLimits &lim);
+
+//return an empty string on success, otherwise what went wrong
+string writePartResult(const string &fname, const PartResult &res);
+string readPartResult(const string &fname, PartResult &res);
+#endif
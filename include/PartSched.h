@@ -0,0 +1,54 @@
+#ifndef PARTSCHED_H
+#define PARTSCHED_H
+#include <vector>
+#include <string>
+#include <bits/stdc++.h>
+#include "Graph.h"
+#include "DFGAnaly.h"
+using namespace std;
+
+//issue limits of the CGRA a partition runs on
+typedef struct CGRAConfig {
+	int fus; //operations issued per cycle
+	int memPorts; //loads, stores and transfers between partitions per cycle
+} CGRAConfig;
+
+//schedule of one partition
+typedef struct partSched {
+	int length; //cycles from the first issue to the last result
+	int ops; //vertices issued
+	int memOps; //port accesses: loads, stores, values read from earlier and written for later partitions
+	double fuUtil; //ops over length * fus
+	double memUtil; //memOps over length * memPorts
+	int II; //initiation interval estimate for back to back invocations
+} partSched;
+
+//Resource-constrained list scheduling of every partition of an ordered partitioning. Each
+//partition is scheduled on its own: values from earlier partitions are read through a memory
+//port before their first use and values used later are written through one after they are
+//produced. Every cycle the ready operations with the longest latency-weighted path to the end
+//of the partition issue first, up to fus vertices and memPorts port accesses. Latencies come
+//from DFGAnaly with the overrides of latTable, transfers take the load and store latencies.
+//Vertex ids are 0..V-1.
+class PartSched {
+	private:
+		int numVertices;
+		CGRAConfig cfg;
+		vector<int> lat; //latency of every vertex
+		vector<char> isMem; //1 for loads and stores
+		vector<vector<int>> succs, preds; //unique neighbours
+		int readLat, writeLat; //latencies of transfers between partitions
+
+	public:
+		PartSched(DAG &gp, CGRAConfig config, const LatencyTable &latTable = LatencyTable());
+
+		//schedules of partitions 0..numParts-1; start gets the issue cycle of every vertex counted
+		//from the start of its partition
+		vector<partSched> schedule(const vector<int> &part, int numParts, vector<int> &start);
+
+		//cycles of one invocation when the partitions run one after another
+		static long totalCycles(const vector<partSched> &scheds);
+
+		void printScheds(const vector<partSched> &scheds) const;
+};
+#endif
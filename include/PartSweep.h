@@ -0,0 +1,51 @@
+#ifndef PARTSWEEP_H
+#define PARTSWEEP_H
+#include <vector>
+#include <string>
+#include <functional>
+#include <bits/stdc++.h>
+#include "Graph.h"
+using namespace std;
+
+//outcome of one (graph, RSize, TSize, loadWeight) job, the fields printStats reports
+typedef struct SweepRecord {
+	string status = "ok"; //ok, infeasible, timeout, memout or crashed
+	int numParts = 0;
+	int iteration = 0; //partition counts tried
+	double objective = 0;
+	int rows = 0; //model size, 0 for solvers without a model
+	int cols = 0;
+	double secs = 0;
+	long peakKB = 0; //peak resident set of the job
+} SweepRecord;
+
+//solve one job, fill rec and return false if no partitioning was found
+typedef function<bool(DAG &gp, int RSize, int TSize, int loadWeight, SweepRecord &rec)> SweepSolver;
+
+//Runs a solver over every graph of a corpus and every point of a parameter grid. Graphs are
+//parsed once in the parent; every job is a forked child sharing them copy-on-write, so a job
+//hitting its time (RLIMIT_CPU and a wall clock alarm) or memory (RLIMIT_AS) limit or crashing
+//only loses its own row. Up to `jobs` children run at once and each finished job appends one
+//line to the results CSV.
+class PartSweep {
+	private:
+		vector<DAG> graphs;
+		vector<string> names;
+		vector<int> RSizes, TSizes, loadWeights;
+		int jobs = 0; //concurrent jobs, 0 for one per core
+		double timeLimit = 0; //seconds per job, 0 for none
+		long memLimitMB = 0; //address space per job, 0 for none
+		string outName = "sweep.csv";
+
+		void addGraph(const string &fname);
+
+	public:
+		//args: corpus entries (dot files, directories of dot files or text files listing dot files),
+		//-R <list> -T <list> -L <list> comma separated, -jobs <n>, -time <secs>, -mem <MB>, -out <csv>;
+		//returns false after printing the usage on bad arguments
+		bool parseArgs(int argc, char **argv, int first);
+
+		//returns the number of jobs that produced a partitioning
+		int run(SweepSolver solver);
+};
+#endif
@@ -0,0 +1,64 @@
+#ifndef PERFMODEL_H
+#define PERFMODEL_H
+#include <vector>
+#include <string>
+#include <bits/stdc++.h>
+#include "Graph.h"
+#include "PartSched.h"
+#include "PartEval.h"
+using namespace std;
+
+//parameters of the machine a partition sequence runs on
+typedef struct perfParams {
+	CGRAConfig cgra = {16, 4}; //FUs and scratchpad ports, the scratchpad bandwidth in words per cycle
+	int reconfig = 100; //cycles to load the configuration of a partition
+	double dramBW = 8; //DRAM words per cycle
+	int dramLat = 100; //cycles to open a load or store group transaction
+	int batch = 1; //invocations run back to back on each configuration
+	bool pipelined = false; //double buffered: prefetch the next partition while one runs
+	LatencyTable latencies; //overrides of the DFGAnaly opcode latencies, see PartSched
+} perfParams;
+
+//predicted time of one partition
+typedef struct partPerf {
+	int compute; //schedule length, scratchpad reads and writes included
+	int II; //initiation interval of back to back invocations
+	int dramIn, dramOut; //cycles fetching load groups and draining store groups
+	long cycles; //reconfig + dramIn + compute + dramOut, pipelined the stage up to the next partition
+} partPerf;
+
+typedef struct perfEstimate {
+	vector<partPerf> parts;
+	long cycles; //one invocation, partitions one after another or overlapped when pipelined
+	double batchCycles; //cycles per invocation over a batch, the inverse of the throughput
+} perfEstimate;
+
+//Analytical execution time of an ordered partitioning. Every partition loads its configuration,
+//fetches its load group transactions from DRAM (dramLat each plus the words at dramBW), runs its
+//list schedule (see PartSched) and drains its store groups the same way. Within a batch a
+//configuration stays loaded and the later invocations start every II cycles, their DRAM traffic
+//is not overlapped.
+//Pipelined (double buffered), the configuration and load groups of partition p + 1 are fetched
+//while p runs and its later invocations overlap their DRAM traffic too, so a stage takes the
+//longer of the execution of p and the prefetch of p + 1. The time per invocation is then the
+//steady state makespan, partition 0 of the next invocation prefetched during the last one.
+class PerfModel {
+	private:
+		perfParams prm;
+		PartSched sched;
+		PartEval eval; //transactions, without limits
+		vector<char> isLoad, isStore;
+
+	public:
+		PerfModel(DAG &gp, perfParams params);
+
+		const perfParams &getParams() const {return prm;}
+		string tag() const; //the parameters, for cache tags
+		perfEstimate estimate(const vector<int> &part, int numParts);
+		void printEstimate(const perfEstimate &est) const;
+};
+
+//"key=value,..." with keys fus, ports, reconfig, dram_bw, dram_lat, batch and pipeline (0 or 1) over base;
+//throws a string on unknown keys or bad values
+perfParams parsePerfParams(const string &spec, perfParams base = perfParams());
+#endif
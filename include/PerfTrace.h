@@ -0,0 +1,56 @@
+#ifndef PERFTRACE_H
+#define PERFTRACE_H
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cstddef>
+using namespace std;
+
+//Lightweight phase timers and counters written as JSON lines, one object per finished phase or
+//counter. Tracing is off unless PerfTrace::open is called or $DFG_PERF_TRACE names the output
+//file; timers and counters cost a clock read and a branch when it is off.
+//Phases report their operator new calls only in binaries also linked with PerfAlloc.o, which
+//replaces the global operator new; build with PERF_ALLOC=PerfAlloc.o to get them. The peak RSS
+//of a phase is its own high water mark, reset through /proc/self/clear_refs when it starts.
+class PerfTrace {
+	public:
+		static void open(const string &fname);
+		static bool enabled();
+
+		//tag added to every following line, normally the graph being processed
+		static void setContext(const string &ctx);
+
+		static void counter(const string &name, long value);
+
+		static bool countingAllocs(); //PerfAlloc.o is linked
+		static long allocCount(); //operator new calls so far
+		static long allocBytes(); //bytes requested from operator new so far
+		static void countAlloc(size_t bytes);
+		static bool hookAllocs(); //called once by PerfAlloc.o
+		static long peakRSSKB(); //high water mark of the resident set since the last reset
+		static bool resetPeakRSS(); //false if the kernel cannot reset it
+		static long currentRSSKB();
+
+		static void emit(const string &json); //one raw line
+		static string quote(const string &s); //JSON string literal
+};
+
+//times the enclosing block and reports it as one phase
+class PerfScope {
+	private:
+		const char *phase;
+		chrono::steady_clock::time_point start;
+		long allocs0, bytes0, rss0;
+		long peak; //high water mark while this phase is open
+
+	public:
+		PerfScope(const char *name);
+		~PerfScope();
+
+		void notePeak(long kb) {peak = max(peak, kb);}
+};
+
+#define PERF_CONCAT2(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT2(a, b)
+#define PERF_SCOPE(name) PerfScope PERF_CONCAT(perfScope, __LINE__)(name)
+#endif
@@ -0,0 +1,57 @@
+#ifndef REACHINDEX_H
+#define REACHINDEX_H
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include <bits/stdc++.h>
+#include "Graph.h"
+#include "BitSet.h"
+using namespace std;
+
+//"is u an ancestor of v" queries and ancestor/descendant counts of a DAG with ids 0..V-1.
+//Graphs whose closure fits in maxBytes keep it as one word-packed bitset row per vertex, built in
+//reverse topological order by OR-ing the rows of the successors, and answer in O(1). Larger
+//graphs keep GRAIL style interval labels from a few randomized DFS traversals: a query whose
+//intervals do not nest is answered at once, otherwise a DFS pruned by the labels decides.
+//Counts are exact in both cases; without the closure they are computed on first use from the
+//closure a block of columns at a time, O(V^2 / 64) word operations.
+class ReachIndex {
+	private:
+		int numVertices;
+		int W = 0; //words per closure row, 0 when the closure is not kept
+		vector<uint64_t> closure; //descendants of v at v * W
+		vector<int> succBeg, succList; //unique successors in CSR form
+		vector<int> order; //topological order
+		vector<int> ancCnt, descCnt; //empty until computed
+		size_t blockBytes; //memory for the closure blocks of computeCounts
+
+		static const int nLabels = 3;
+		vector<int> lo[nLabels], post[nLabels]; //interval labels, v reaches u only if lo_v <= lo_u, post_u <= post_v
+		vector<int> topoRank;
+		vector<int> seen; //stamps for the pruned DFS
+		int stamp = 0;
+
+		void countBlock(int c0, int c1, vector<uint64_t> &rows);
+		void computeCounts();
+		void buildLabels();
+		bool labelsNest(int u, int v) const;
+
+	public:
+		ReachIndex(DAG &gp, size_t maxBytes = (size_t)256 << 20);
+
+		bool isDense() const {return W > 0;}
+
+		//u == v or there is a path u -> v; the sparse path is not thread safe
+		bool reaches(int u, int v);
+
+		int numAncestors(int v) {
+			if(ancCnt.empty()) computeCounts();
+			return ancCnt[v];
+		}
+		int numDescendants(int v) {
+			if(descCnt.empty()) computeCounts();
+			return descCnt[v];
+		}
+		const vector<int> &getTopoOrder() const {return order;}
+};
+#endif
@@ -0,0 +1,40 @@
+#ifndef ROLLINGHORIZON_H
+#define ROLLINGHORIZON_H
+#include <vector>
+#include <string>
+#include <bits/stdc++.h>
+#include "Graph.h"
+#include "DFGDecomp.h"
+using namespace std;
+
+//Rolling horizon partitioning for DFGs too large for a single model. A window holds the
+//unfrozen vertices of the next winLevels ASAP levels and is partitioned on its own; values
+//produced by frozen partitions enter it as boundary reads and values consumed beyond it as
+//boundary writes. All but the last `overlap` partitions of the window are frozen, the window
+//slides to the earliest unfrozen level and the rest is solved again with the next levels.
+//Pipelined, a window's first partition is prefetched during the last frozen one, so the window
+//gets that partition's reads (SubProblem::prevReads) and empty frozen partitions are kept to
+//leave the prefetch chain of the window as it was solved.
+class RollingHorizon {
+	private:
+		DAG gp;
+		int numVertices;
+		int winLevels; //ASAP levels per window
+		int overlap; //window partitions left unfrozen for the next window
+		bool pipelined = false; //keep empty frozen partitions, see setPipelined
+		vector<vector<int>> succs, preds; //unique neighbours
+		vector<int> level; //ASAP level of each vertex
+
+		void buildWindow(const vector<int> &verts, const vector<int> &frozen, SubProblem &sp);
+
+	public:
+		RollingHorizon(DAG &grph, int winlevels, int ovlap);
+
+		//windows are solved under the pipelined read budget, see partLimits
+		void setPipelined(bool p) {pipelined = p;}
+
+		//partition the whole graph window by window; returns the partition count or -1 if a
+		//window could not be solved
+		int solve(SubSolver solver, vector<int> &part);
+};
+#endif
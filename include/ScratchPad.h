@@ -0,0 +1,43 @@
+#ifndef SCRATCHPAD_H
+#define SCRATCHPAD_H
+#include <vector>
+#include <string>
+#include <bits/stdc++.h>
+#include "Graph.h"
+using namespace std;
+
+//a value kept in the scratchpad between the partition producing it and the last one reading it
+typedef struct padValue {
+	int vertex; //producer
+	int from, to; //resident while partitions from..to run: written by from - 1, last read by to
+	int slot; //buffer slot, values sharing a slot have disjoint lifetimes
+} padValue;
+
+//Scratchpad liveness of an ordered partitioning. The sc_pad_write of a value leaving its
+//partition fills a buffer that stays occupied until the last partition reading it has run, so
+//the values crossing a boundary are the ones resident in the partition after it. Slots come
+//from left edge interval coloring, which needs exactly the peak occupancy. The partitioners take
+//a cap on the resident values of every partition (the drivers' -spad), INT_MAX for none.
+//Values crossing the boundary of a windowed model are not counted there.
+class ScratchPad {
+	private:
+		int numVertices;
+		vector<int> succBeg, succList; //unique successors of each vertex in CSR form
+
+	public:
+		ScratchPad(DAG &gp);
+
+		//slots given as a -spad argument; throws a string unless it is a number >= 0
+		static int parseCapacity(const string &arg);
+
+		//resident values ordered by from, each with a slot
+		vector<padValue> liveness(const vector<int> &part, int numParts) const;
+
+		//values resident while each partition runs, the live set of the boundary before it
+		static vector<int> occupancy(const vector<padValue> &vals, int numParts);
+		static int slotsUsed(const vector<padValue> &vals);
+
+		//occupancy per boundary, peak and lifetimes; listValues adds vertex@slot of every live value
+		static void printLiveness(const vector<padValue> &vals, int numParts, bool listValues = false);
+};
+#endif
@@ -0,0 +1,75 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+using namespace std;
+
+//Fixed size pool of worker threads running queued jobs; wait() blocks until the queue drains.
+class ThreadPool {
+	private:
+		vector<thread> workers;
+		queue<function<void()>> jobs;
+		mutex mtx;
+		condition_variable jobReady; //signalled when a job is queued or on shutdown
+		condition_variable allDone; //signalled when the last running job finishes
+		int running = 0; //jobs taken off the queue but not finished
+		bool stopping = false;
+
+		void workerLoop() {
+			while(true) {
+				function<void()> job;
+				{
+					unique_lock<mutex> lk(mtx);
+					jobReady.wait(lk, [this] {return stopping || !jobs.empty();});
+					if(jobs.empty()) return; //stopping and nothing left
+					job = move(jobs.front());
+					jobs.pop();
+					running++;
+				}
+				job();
+				{
+					unique_lock<mutex> lk(mtx);
+					running--;
+					if(running == 0 && jobs.empty()) allDone.notify_all();
+				}
+			}
+		}
+
+	public:
+		ThreadPool(int nThreads) {
+			if(nThreads < 1) nThreads = thread::hardware_concurrency();
+			if(nThreads < 1) nThreads = 1;
+			for(int i = 0; i < nThreads; i++) {
+				workers.push_back(thread(&ThreadPool::workerLoop, this));
+			}
+		}
+
+		~ThreadPool() {
+			{
+				unique_lock<mutex> lk(mtx);
+				stopping = true;
+			}
+			jobReady.notify_all();
+			for(auto &t : workers) t.join();
+		}
+
+		int size() const {return workers.size();}
+
+		void submit(function<void()> job) {
+			{
+				unique_lock<mutex> lk(mtx);
+				jobs.push(move(job));
+			}
+			jobReady.notify_one();
+		}
+
+		void wait() {
+			unique_lock<mutex> lk(mtx);
+			allDone.wait(lk, [this] {return running == 0 && jobs.empty();});
+		}
+};
+#endif
@@ -0,0 +1,150 @@
+#include "BitSet.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BITSET_AVX2
+#include <immintrin.h>
+
+//the AVX2 kernels are compiled for AVX2 whatever the build flags and only called when the CPU
+//has it; a build with -mavx2 skips the check
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+#ifdef __AVX2__
+static const bool useAVX2 = true;
+#else
+static bool detectAVX2() {
+	__builtin_cpu_init(); //may run before the constructors that would otherwise do it
+	return __builtin_cpu_supports("avx2");
+}
+static const bool useAVX2 = detectAVX2();
+#endif
+
+//bits set in every byte of v summed into four 64 bit lanes, nibble lookup as in Mula's popcount
+static inline AVX2_TARGET __m256i popcount256(__m256i v) {
+	const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+		0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	const __m256i low = _mm256_set1_epi8(0x0f);
+	__m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low));
+	__m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+	return _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+}
+
+static inline AVX2_TARGET size_t sumLanes(__m256i acc) {
+	return _mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1) + _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3);
+}
+
+//whole 256 bit blocks of the kernels below, each returns the words it covered
+static AVX2_TARGET size_t orBlocks(uint64_t *dst, const uint64_t *src, size_t n) {
+	size_t i = 0;
+	for(; i + 4 <= n; i += 4) {
+		__m256i a = _mm256_loadu_si256((const __m256i *)(dst + i));
+		__m256i b = _mm256_loadu_si256((const __m256i *)(src + i));
+		_mm256_storeu_si256((__m256i *)(dst + i), _mm256_or_si256(a, b));
+	}
+	return i;
+}
+
+static AVX2_TARGET size_t andBlocks(uint64_t *dst, const uint64_t *src, size_t n) {
+	size_t i = 0;
+	for(; i + 4 <= n; i += 4) {
+		__m256i a = _mm256_loadu_si256((const __m256i *)(dst + i));
+		__m256i b = _mm256_loadu_si256((const __m256i *)(src + i));
+		_mm256_storeu_si256((__m256i *)(dst + i), _mm256_and_si256(a, b));
+	}
+	return i;
+}
+
+static AVX2_TARGET size_t xorBlocks(uint64_t *dst, const uint64_t *src, size_t n) {
+	size_t i = 0;
+	for(; i + 4 <= n; i += 4) {
+		__m256i a = _mm256_loadu_si256((const __m256i *)(dst + i));
+		__m256i b = _mm256_loadu_si256((const __m256i *)(src + i));
+		_mm256_storeu_si256((__m256i *)(dst + i), _mm256_xor_si256(a, b));
+	}
+	return i;
+}
+
+static AVX2_TARGET size_t popcountBlocks(const uint64_t *a, size_t n, size_t &cnt) {
+	size_t i = 0;
+	__m256i acc = _mm256_setzero_si256();
+	for(; i + 4 <= n; i += 4) {
+		acc = _mm256_add_epi64(acc, popcount256(_mm256_loadu_si256((const __m256i *)(a + i))));
+	}
+	cnt = sumLanes(acc);
+	return i;
+}
+
+static AVX2_TARGET size_t popcountAndBlocks(const uint64_t *a, const uint64_t *b, size_t n, size_t &cnt) {
+	size_t i = 0;
+	__m256i acc = _mm256_setzero_si256();
+	for(; i + 4 <= n; i += 4) {
+		__m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+		__m256i y = _mm256_loadu_si256((const __m256i *)(b + i));
+		acc = _mm256_add_epi64(acc, popcount256(_mm256_and_si256(x, y)));
+	}
+	cnt = sumLanes(acc);
+	return i;
+}
+#endif
+
+void orWords(uint64_t *dst, const uint64_t *src, size_t n) {
+	size_t i = 0;
+#ifdef BITSET_AVX2
+	if(useAVX2) i = orBlocks(dst, src, n);
+#endif
+	for(; i < n; i++) {
+		dst[i] |= src[i];
+	}
+}
+
+void andWords(uint64_t *dst, const uint64_t *src, size_t n) {
+	size_t i = 0;
+#ifdef BITSET_AVX2
+	if(useAVX2) i = andBlocks(dst, src, n);
+#endif
+	for(; i < n; i++) {
+		dst[i] &= src[i];
+	}
+}
+
+void xorWords(uint64_t *dst, const uint64_t *src, size_t n) {
+	size_t i = 0;
+#ifdef BITSET_AVX2
+	if(useAVX2) i = xorBlocks(dst, src, n);
+#endif
+	for(; i < n; i++) {
+		dst[i] ^= src[i];
+	}
+}
+
+size_t popcountWords(const uint64_t *a, size_t n) {
+	size_t i = 0, cnt = 0;
+#ifdef BITSET_AVX2
+	if(useAVX2 && n >= 8) i = popcountBlocks(a, n, cnt);
+#endif
+	for(; i < n; i++) {
+		cnt += __builtin_popcountll(a[i]);
+	}
+	return cnt;
+}
+
+size_t popcountAnd(const uint64_t *a, const uint64_t *b, size_t n) {
+	size_t i = 0, cnt = 0;
+#ifdef BITSET_AVX2
+	if(useAVX2 && n >= 8) i = popcountAndBlocks(a, b, n, cnt);
+#endif
+	for(; i < n; i++) {
+		cnt += __builtin_popcountll(a[i] & b[i]);
+	}
+	return cnt;
+}
+
+int nextBit(const uint64_t *a, size_t n, int from) {
+	if(from < 0) from = 0;
+	size_t w = from >> 6;
+	if(w >= n) return -1;
+	uint64_t bits = a[w] & (~0ULL << (from & 63));
+	while(!bits) {
+		if(++w == n) return -1;
+		bits = a[w];
+	}
+	return w * 64 + __builtin_ctzll(bits);
+}
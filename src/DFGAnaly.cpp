@@ -1,4 +1,5 @@
 #include "DFGAnaly.h"
+#include "DFGUtils.h"
 using namespace std;
 DFGAnaly::DFGAnaly() {}
 DFGAnaly::DFGAnaly(DAG grph) {
@@ -40,18 +41,15 @@ vector<uint32_t> DFGAnaly::topoSort() {
 	return order;
 }
 uint32_t DFGAnaly::assignTime(vector<uint32_t> &topOrder, vector<int32_t> &timeSt) {
-	for(uint32_t i = 0; i < gp.getNumNodes(); i++) {
-		timeSt.push_back(-1);
-	}
+	const vector<int> &lt = latencies();
+	timeSt.assign(gp.getNumNodes(), -1);
 
 	int32_t timeMax = 0;
 	int count_load_1 = 0;
 	for(uint32_t n : topOrder) {
-		//cout << n << " ";
 		list<Node> preds;
 		gp.getPredecessors(n, preds);
 		int32_t max = 0;
-		string label = gp.findNode(n)->getLabel();
 		for(Node prNode : preds) {
 			uint32_t id = prNode.getID();
 			if(timeSt[id] == -1) {
@@ -62,29 +60,8 @@ uint32_t DFGAnaly::assignTime(vector<uint32_t> &topOrder, vector<int32_t> &timeS
 				max = timeSt[id];
 			}
 		}
-		/*if((label.find("load") != std::string::npos)) {
-			int stride = stoi(label.substr(label.find(";") + 1, label.length()));
-			if(stride >= STRIDE_MIN) {
-				timeSt[n] = max;
-			}
-			else {
-				timeSt[n] = max + 1;//nodeWts["load"];
-			}
-		}
-		else if((label.find("store") != std::string::npos)) {
-			int stride = stoi(label.substr(label.find(";") + 1, label.length()));
-			if(stride >= STRIDE_MIN) {
-				timeSt[n] = max;
-			}
-			else {
-				timeSt[n] = max + 1; //nodeWts["store"];
-			}
-		}
-		else {
-			timeSt[n] = max + 1;//nodeWts[label];
-		}*/
-		timeSt[n] = max + 1;
-		if(timeSt[n] == 1 && label.find("load") != std::string::npos) {
+		timeSt[n] = max + lt[n];
+		if(max == 0 && gp.findNode(n)->getLabel().find("load") != std::string::npos) {
 			count_load_1++;
 		}
 
@@ -96,36 +73,167 @@ uint32_t DFGAnaly::assignTime(vector<uint32_t> &topOrder, vector<int32_t> &timeS
 	cout << count_load_1 << " loads at timestamp 1 " << endl;
 	return timeMax;
 }
+
 double DFGAnaly::getParallelism() {
 	vector<uint32_t> topOrder = topoSort();
 	vector<int32_t> timeSt; 
 	uint32_t timeMax = assignTime(topOrder, timeSt);
-	/*cout << "Time Max is " << timeMax << endl;
-	cout << "Topological sort order is\n";
-	for(uint32_t n : topOrder) {
-		cout << gp.findNode(n)->getLabel() << " has time " << timeSt[n] << endl;
-	}
-	cout << endl;
-	*/
-	double total = 0;
-	for(uint32_t i = 0; i <= timeMax; i++) {
-		total+= count(timeSt.begin(), timeSt.end(), i);	
-	}
-	
-	return total/timeMax;
+	return double(timeSt.size()) / timeMax;
 }
 
 uint32_t DFGAnaly::criticalPathLen() {
 	vector<uint32_t> topOrder = topoSort();
 	vector<int32_t> timeSt; 
 	uint32_t timeMax = assignTime(topOrder, timeSt);
-	for(int i = 0; i <= timeMax; i++) {
-		cout << " Node level " << i << " has count " << count(timeSt.begin(), timeSt.end(), i)  << " " ;
+	vector<int> levelCnt(timeMax + 1, 0);
+	for(int32_t t : timeSt) {
+		levelCnt[t]++;
+	}
+	for(uint32_t i = 0; i <= timeMax; i++) {
+		cout << " Node level " << i << " has count " << levelCnt[i] << " " ;
 	}
 	cout << endl;
 	return timeMax;
 }
 
+bool DFGAnaly::readLatencyTable(const string &fname, LatencyTable &table) {
+	ifstream in(fname);
+	if(!in) {
+		return false;
+	}
+	string line;
+	while(getline(in, line)) {
+		line = line.substr(0, line.find('#'));
+		size_t end = line.find_last_not_of(" \t\r");
+		if(end == string::npos) continue;
+		size_t pos = line.find_last_of(" \t", end);
+		size_t opEnd = line.find_last_not_of(" \t", pos);
+		size_t opBeg = line.find_first_not_of(" \t");
+		string cycles = pos == string::npos ? "" : line.substr(pos + 1, end - pos);
+		if(pos == string::npos || opEnd == string::npos || cycles.find_first_not_of("0123456789") != string::npos || cycles.size() > 9 || stoi(cycles) < 1) {
+			throw string("Bad latency table line: ") + line;
+		}
+		table[line.substr(opBeg, opEnd - opBeg + 1)] = stoi(cycles);
+	}
+	return true;
+}
+
+void DFGAnaly::setLatencies(const LatencyTable &table) {
+	for(auto &kv : table) {
+		setLatency(kv.first, kv.second);
+	}
+}
+
+void DFGAnaly::setLatency(const string &op, int cycles) {
+	string key = op;
+	transform(key.begin(), key.end(), key.begin(), ::tolower);
+	nodeWts[key] = cycles;
+	tableSet = true;
+	lat.clear();
+}
+
+int DFGAnaly::opLatency(const string &label) const {
+	size_t semi = label.find(';');
+	string op = opcodeOf(label);
+	bool strideLabel = label.compare(0, 5, "load;") == 0 || label.compare(0, 6, "store;") == 0;
+	if(strideLabel && semi + 1 < label.size() && isdigit(label[semi + 1]) && stoi(label.substr(semi + 1)) >= STRIDE_MIN) {
+		op += "_strided";
+	}
+	map<string, int>::const_iterator it = nodeWts.find(op);
+	if(it == nodeWts.end()) {
+		it = nodeWts.find("default");
+	}
+	return it != nodeWts.end() ? max(1, it->second) : 1;
+}
+
+const vector<int> &DFGAnaly::latencies() {
+	if(lat.empty()) {
+		lat.assign(gp.getNumNodes(), 1);
+		for(list<Node>::iterator it = gp.nodeBegin(); it != gp.nodeEnd(); it++) {
+			lat[it->getID()] = opLatency(it->getLabel());
+		}
+	}
+	return lat;
+}
+
+string DFGAnaly::latencyTag() const {
+	if(!tableSet) {
+		return "";
+	}
+	string table;
+	for(auto &kv : nodeWts) {
+		table += kv.first + "=" + to_string(kv.second) + ";";
+	}
+	char hex[17];
+	snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)hashString(table));
+	return hex;
+}
+
+void DFGAnaly::buildOrder() {
+	if(!order.empty() || gp.getNumNodes() == 0) {
+		return;
+	}
+	int n = gp.getNumNodes();
+	succs.assign(n, vector<int>());
+	for(list<Edge>::iterator it = gp.edgeBegin(); it != gp.edgeEnd(); it++) {
+		succs[it->getSrcNodeID()].push_back(it->getDestNodeID());
+	}
+	vector<int> indeg(n, 0);
+	for(auto &sv : succs) {
+		sort(sv.begin(), sv.end());
+		sv.erase(unique(sv.begin(), sv.end()), sv.end());
+		for(int s : sv) indeg[s]++;
+	}
+	for(int v = 0; v < n; v++) {
+		if(indeg[v] == 0) order.push_back(v);
+	}
+	for(int h = 0; h < (int)order.size(); h++) {
+		for(int s : succs[order[h]]) {
+			if(--indeg[s] == 0) order.push_back(s);
+		}
+	}
+}
+
+int DFGAnaly::asap(vector<int> &start) {
+	const vector<int> &lt = latencies();
+	buildOrder();
+	start.assign(gp.getNumNodes(), 0);
+	int length = 0;
+	for(int v : order) {
+		int finish = start[v] + lt[v];
+		length = max(length, finish);
+		for(int s : succs[v]) {
+			start[s] = max(start[s], finish);
+		}
+	}
+	return length;
+}
+
+void DFGAnaly::alap(int length, vector<int> &start) {
+	const vector<int> &lt = latencies();
+	buildOrder();
+	start.assign(gp.getNumNodes(), 0);
+	for(int h = (int)order.size() - 1; h >= 0; h--) {
+		int v = order[h];
+		int latest = length;
+		for(int s : succs[v]) {
+			latest = min(latest, start[s]);
+		}
+		start[v] = latest - lt[v];
+	}
+}
+
+int DFGAnaly::slack(vector<int> &sl) {
+	vector<int> early, late;
+	int length = asap(early);
+	alap(length, late);
+	sl.resize(early.size());
+	for(size_t v = 0; v < early.size(); v++) {
+		sl[v] = late[v] - early[v];
+	}
+	return length;
+}
+
 void DFGAnaly::getBasicProps() {
 	uint32_t nodes = gp.getNumNodes();
 	uint32_t edges = gp.getNumEdges();
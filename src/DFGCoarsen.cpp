@@ -0,0 +1,89 @@
+#include "DFGCoarsen.h"
+#include "DFGUtils.h"
+
+DFGCoarsen::DFGCoarsen(DAG &grph, int maxwt) {
+	gp = grph;
+	numVertices = gp.getNumNodes();
+	maxWeight = max(1, maxwt);
+}
+
+int DFGCoarsen::coarsen() {
+	vector<vector<int>> succs(numVertices);
+	vector<int> indeg(numVertices, 0);
+	for(list<Edge>::iterator it = gp.edgeBegin(); it != gp.edgeEnd(); it++) {
+		succs[it->getSrcNodeID()].push_back(it->getDestNodeID());
+	}
+	for(int v = 0; v < numVertices; v++) {
+		sort(succs[v].begin(), succs[v].end());
+		succs[v].erase(unique(succs[v].begin(), succs[v].end()), succs[v].end());
+		for(int s : succs[v]) indeg[s]++;
+	}
+	vector<char> mem(numVertices, 0);
+	for(list<Node>::iterator it = gp.nodeBegin(); it != gp.nodeEnd(); it++) {
+		string op = it->getLabel();
+		mem[it->getID()] = isLoadOp(op) || isStoreOp(op);
+	}
+
+	//topological order, walked backwards so a vertex joins its successor's cluster only after
+	//that successor has decided where it belongs
+	vector<int> order;
+	for(int v = 0; v < numVertices; v++) {
+		if(indeg[v] == 0) order.push_back(v);
+	}
+	for(int h = 0; h < (int)order.size(); h++) {
+		for(int s : succs[order[h]]) {
+			if(--indeg[s] == 0) order.push_back(s);
+		}
+	}
+
+	vector<int> root(numVertices), rootWt(numVertices, 1);
+	iota(root.begin(), root.end(), 0);
+	for(int h = numVertices - 1; h >= 0; h--) {
+		int u = order[h];
+		if(mem[u] || succs[u].size() != 1) continue;
+		int v = succs[u][0];
+		if(mem[v]) continue;
+		int r = root[v];
+		if(rootWt[r] + 1 > maxWeight) continue;
+		root[u] = r;
+		rootWt[r]++;
+	}
+
+	//number the clusters in the original id order of their roots
+	clusterOf.assign(numVertices, -1);
+	weight.clear();
+	vector<int> cid(numVertices, -1);
+	for(int v = 0; v < numVertices; v++) {
+		if(root[v] != v) continue;
+		cid[v] = weight.size();
+		weight.push_back(rootWt[v]);
+		coarse.addNode(cid[v], gp.findNode(v)->getLabel());
+	}
+	for(int v = 0; v < numVertices; v++) {
+		clusterOf[v] = cid[root[v]];
+	}
+
+	//one edge per (cluster, cluster) pair, only the root's value leaves a cluster
+	set<pair<int, int>> cedges;
+	for(int v = 0; v < numVertices; v++) {
+		for(int s : succs[v]) {
+			if(clusterOf[v] != clusterOf[s]) cedges.insert({clusterOf[v], clusterOf[s]});
+		}
+	}
+	int edgeId = 0;
+	for(auto &e : cedges) {
+		coarse.addEdge(edgeId++, e.first, e.second, "1:1");
+	}
+	coarse.setName(gp.getName());
+
+	cout << "Coarsened " << numVertices << " vertices into " << weight.size() << " clusters" << endl;
+	return weight.size();
+}
+
+vector<int> DFGCoarsen::expand(const vector<int> &coarsePart) const {
+	vector<int> part(numVertices);
+	for(int v = 0; v < numVertices; v++) {
+		part[v] = coarsePart[clusterOf[v]];
+	}
+	return part;
+}
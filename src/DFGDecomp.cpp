@@ -0,0 +1,441 @@
+#include "DFGDecomp.h"
+#include "DFGUtils.h"
+#include "ThreadPool.h"
+
+DFGDecomp::DFGDecomp(DAG &grph, int cutmax, int minpiece) {
+	gp = grph;
+	cutMax = cutmax;
+	minPiece = minpiece;
+	numVertices = gp.getNumNodes();
+	succs.resize(numVertices);
+	preds.resize(numVertices);
+	for(list<Edge>::iterator it = gp.edgeBegin(); it != gp.edgeEnd(); it++) {
+		succs[it->getSrcNodeID()].push_back(it->getDestNodeID());
+		preds[it->getDestNodeID()].push_back(it->getSrcNodeID());
+	}
+	for(int v = 0; v < numVertices; v++) {
+		sort(succs[v].begin(), succs[v].end());
+		succs[v].erase(unique(succs[v].begin(), succs[v].end()), succs[v].end());
+		sort(preds[v].begin(), preds[v].end());
+		preds[v].erase(unique(preds[v].begin(), preds[v].end()), preds[v].end());
+	}
+}
+
+//find the most balanced cheap articulation cut of a connected piece; cutSide gets the
+//vertices hanging off the articulation vertex, returns false if there is no such cut
+bool DFGDecomp::findCut(const vector<int> &verts, vector<int> &cutSide) {
+	int n = verts.size();
+	if(n < 2 * minPiece) return false;
+
+	unordered_map<int, int> loc; //original id -> local id
+	loc.reserve(n * 2);
+	for(int i = 0; i < n; i++) loc[verts[i]] = i;
+
+	//undirected adjacency restricted to the piece
+	vector<vector<int>> adj(n);
+	for(int i = 0; i < n; i++) {
+		for(int s : succs[verts[i]]) {
+			auto it = loc.find(s);
+			if(it == loc.end()) continue;
+			adj[i].push_back(it->second);
+			adj[it->second].push_back(i);
+		}
+	}
+
+	//iterative dfs computing preorder numbers, low links and subtree sizes
+	vector<int> disc(n, -1), low(n, 0), parent(n, -1), sub(n, 1), order;
+	vector<vector<int>> children(n);
+	vector<pair<int, int>> st; //vertex, next neighbour index
+	int time = 0;
+	disc[0] = low[0] = time++;
+	order.push_back(0);
+	st.push_back({0, 0});
+	while(!st.empty()) {
+		int v = st.back().first;
+		if(st.back().second < (int)adj[v].size()) {
+			int w = adj[v][st.back().second++];
+			if(disc[w] == -1) {
+				parent[w] = v;
+				children[v].push_back(w);
+				disc[w] = low[w] = time++;
+				order.push_back(w);
+				st.push_back({w, 0});
+			}
+			else if(w != parent[v]) {
+				low[v] = min(low[v], disc[w]);
+			}
+		}
+		else {
+			st.pop_back();
+			if(parent[v] != -1) {
+				low[parent[v]] = min(low[parent[v]], low[v]);
+				sub[parent[v]] += sub[v];
+			}
+		}
+	}
+	if(time != n) return false; //piece is not connected, caller splits components first
+
+	int bestA = -1, bestC = -1, bestBal = 0;
+	for(int a = 0; a < n; a++) {
+		if(children[a].empty()) continue;
+		int nc = children[a].size();
+		//values crossing between a and each child subtree, subtrees are contiguous preorder ranges
+		vector<int> upSrcs(nc, 0);
+		vector<char> down(nc, 0);
+		auto childOf = [&](int w) {
+			int lo = 0, hi = nc - 1;
+			while(lo < hi) {
+				int mid = (lo + hi + 1) / 2;
+				if(disc[children[a][mid]] <= disc[w]) lo = mid;
+				else hi = mid - 1;
+			}
+			int c = children[a][lo];
+			return (disc[w] >= disc[c] && disc[w] < disc[c] + sub[c]) ? lo : -1;
+		};
+		for(int p : preds[verts[a]]) {
+			auto it = loc.find(p);
+			if(it == loc.end() || disc[it->second] <= disc[a]) continue;
+			int ci = childOf(it->second);
+			if(ci != -1) upSrcs[ci]++;
+		}
+		for(int s : succs[verts[a]]) {
+			auto it = loc.find(s);
+			if(it == loc.end() || disc[it->second] <= disc[a]) continue;
+			int ci = childOf(it->second);
+			if(ci != -1) down[ci] = 1;
+		}
+		for(int ci = 0; ci < nc; ci++) {
+			int c = children[a][ci];
+			if(low[c] < disc[a]) continue; //subtree still attached above a
+			if(parent[a] == -1 && nc < 2) continue; //root with one child is no articulation
+			if(upSrcs[ci] > 0 && down[ci]) continue; //values cross both ways
+			int crossing = down[ci] ? 1 : upSrcs[ci];
+			if(crossing > cutMax) continue;
+			int bal = min(sub[c], n - sub[c]);
+			if(bal >= minPiece && bal > bestBal) {
+				bestBal = bal;
+				bestA = a;
+				bestC = c;
+			}
+		}
+	}
+	if(bestA == -1) return false;
+
+	cutSide.clear();
+	for(int k = disc[bestC]; k < disc[bestC] + sub[bestC]; k++) {
+		cutSide.push_back(verts[order[k]]);
+	}
+	return true;
+}
+
+void DFGDecomp::splitPiece(vector<int> &verts) {
+	vector<int> cutSide;
+	if(!findCut(verts, cutSide)) {
+		pieces.push_back(verts);
+		return;
+	}
+	unordered_set<int> inCut(cutSide.begin(), cutSide.end());
+	vector<int> rest;
+	for(int v : verts) {
+		if(inCut.find(v) == inCut.end()) rest.push_back(v);
+	}
+	splitPiece(cutSide);
+	splitPiece(rest);
+}
+
+//build the piece graph with pseudo nodes for values entering or leaving the piece
+void DFGDecomp::buildSub(int p, int &nextGroup) {
+	SubProblem &sp = subs[p];
+	vector<int> &verts = pieces[p];
+	sort(verts.begin(), verts.end());
+	sp.origIds = verts;
+	sp.numReal = verts.size();
+	unordered_map<int, int> loc;
+	for(int i = 0; i < (int)verts.size(); i++) {
+		loc[verts[i]] = i;
+		sp.graph.addNode(i, gp.findNode(verts[i])->getLabel());
+	}
+
+	int norm = verts.size();
+	int edgeId = 0;
+	map<int, int> inVals; //outside producer -> pseudo load
+	for(int i = 0; i < (int)verts.size(); i++) {
+		int v = verts[i];
+		bool leaves = false;
+		for(int s : succs[v]) {
+			if(pieceOf[s] == p) {
+				sp.graph.addEdge(edgeId++, i, loc[s], "1:1");
+			}
+			else {
+				leaves = true;
+			}
+		}
+		if(leaves) { //value consumed by a later piece, costs one write here
+			sp.graph.addNode(norm, "store;" + to_string(nextGroup++));
+			sp.graph.addEdge(edgeId++, i, norm, "1:1");
+			norm++;
+		}
+		for(int q : preds[v]) {
+			if(pieceOf[q] == p) continue;
+			if(pipelined) { //a pseudo load would be prefetched a partition early, a boundary read is not
+				if(inVals.find(q) == inVals.end()) {
+					inVals[q] = sp.bndReads.size();
+					sp.bndReads.push_back(vector<int>());
+				}
+				sp.bndReads[inVals[q]].push_back(i);
+				continue;
+			}
+			if(inVals.find(q) == inVals.end()) { //value produced by an earlier piece, one read per partition using it
+				inVals[q] = norm;
+				sp.graph.addNode(norm, "load;" + to_string(nextGroup++));
+				norm++;
+			}
+			sp.graph.addEdge(edgeId++, inVals[q], i, "1:1");
+		}
+	}
+	sp.label = "piece" + to_string(p);
+	sp.graph.setName(gp.getName() + "_" + sp.label);
+}
+
+int DFGDecomp::decompose() {
+	//weakly connected components with union find
+	vector<int> uf(numVertices);
+	iota(uf.begin(), uf.end(), 0);
+	function<int(int)> root = [&](int x) {
+		while(uf[x] != x) {
+			uf[x] = uf[uf[x]];
+			x = uf[x];
+		}
+		return x;
+	};
+	for(int v = 0; v < numVertices; v++) {
+		for(int s : succs[v]) {
+			uf[root(v)] = root(s);
+		}
+	}
+	map<int, vector<int>> comps;
+	for(int v = 0; v < numVertices; v++) {
+		comps[root(v)].push_back(v);
+	}
+
+	pieces.clear();
+	for(auto &c : comps) {
+		splitPiece(c.second);
+	}
+	pieceOf.assign(numVertices, -1);
+	for(int p = 0; p < (int)pieces.size(); p++) {
+		for(int v : pieces[p]) pieceOf[v] = p;
+	}
+
+	//fresh group ids for pseudo nodes start after the largest id used in the graph
+	int nextGroup = 0;
+	for(list<Node>::iterator it = gp.nodeBegin(); it != gp.nodeEnd(); it++) {
+		string op = it->getLabel();
+		if(isLoadOp(op) || isStoreOp(op)) {
+			nextGroup = max(nextGroup, getMemGroup(op) + 1);
+		}
+	}
+	subs.clear();
+	subs.resize(pieces.size());
+	for(int p = 0; p < (int)pieces.size(); p++) {
+		buildSub(p, nextGroup);
+	}
+
+	cout << "Decomposed into " << comps.size() << " components and " << pieces.size() << " pieces" << endl;
+	return pieces.size();
+}
+
+bool DFGDecomp::solveAll(SubSolver solver, int nThreads) {
+	//largest pieces first so the pool stays busy
+	vector<int> order(subs.size());
+	iota(order.begin(), order.end(), 0);
+	sort(order.begin(), order.end(), [&](int a, int b) {return subs[a].numReal > subs[b].numReal;});
+
+	ThreadPool pool(nThreads);
+	for(int p : order) {
+		pool.submit([&, p] {
+			subs[p].solved = solver(subs[p]);
+		});
+	}
+	pool.wait();
+
+	bool allSolved = true;
+	for(auto &sp : subs) {
+		allSolved = allSolved && sp.solved;
+	}
+	return allSolved;
+}
+
+int DFGDecomp::merge(PartEval &eval, vector<int> &part) {
+	int np = subs.size();
+	//dependences between pieces follow the cut edges
+	vector<vector<int>> pieceSuccs(np);
+	vector<int> indeg(np, 0);
+	for(int v = 0; v < numVertices; v++) {
+		for(int s : succs[v]) {
+			if(pieceOf[v] != pieceOf[s]) {
+				pieceSuccs[pieceOf[v]].push_back(pieceOf[s]);
+			}
+		}
+	}
+	for(auto &ps : pieceSuccs) {
+		sort(ps.begin(), ps.end());
+		ps.erase(unique(ps.begin(), ps.end()), ps.end());
+		for(int q : ps) indeg[q]++;
+	}
+
+	vector<partCounts> slots; //counts of the merged partitions
+	const partLimits &lim = eval.getLimits();
+	const vector<int> &classUse = eval.getClassUse();
+	int nc = classUse.empty() ? 0 : lim.fu.numClasses();
+	vector<long> slotClass; //FU class usage of the merged partitions, slot major
+	vector<int> lastUse(numVertices, -1); //merged partition of the last consumer placed so far, see ScratchPad
+	vector<int> seen(numVertices, -1);
+	int stamp = 0;
+	vector<int> minSlot(np, 0); //first merged partition a piece may use
+	part.assign(numVertices, -1);
+	queue<int> ready;
+	for(int p = 0; p < np; p++) {
+		if(indeg[p] == 0) ready.push(p);
+	}
+
+	int done = 0;
+	while(!ready.empty()) {
+		int p = ready.front();
+		ready.pop();
+		done++;
+		SubProblem &sp = subs[p];
+		PartEval subEval(sp.graph, lim);
+		vector<partCounts> counts;
+		string err = subEval.validate(sp.part, sp.numParts, counts);
+		if(!err.empty()) {
+			cout << "Piece " << p << " solution invalid: " << err << endl;
+			return -1;
+		}
+		for(auto &rd : sp.bndReads) { //values a pipelined piece reads from earlier pieces
+			set<int> pts;
+			for(int i : rd) pts.insert(sp.part[i]);
+			for(int q : pts) counts[q].reads++;
+		}
+
+		//FU class usage of every partition of the piece
+		vector<long> pieceClass((size_t)sp.numParts * nc, 0);
+		for(int i = 0; i < sp.numReal && nc > 0; i++) {
+			for(int c = 0; c < nc; c++) {
+				pieceClass[(size_t)sp.part[i] * nc + c] += classUse[(size_t)sp.origIds[i] * nc + c];
+			}
+		}
+		auto fitsClasses = [&](int s, int q) {
+			for(int c = 0; c < nc; c++) {
+				if(slotClass[(size_t)s * nc + c] + pieceClass[(size_t)q * nc + c] > lim.fu.getCapacity(c)) return false;
+			}
+			return true;
+		};
+
+		//values of earlier merged partitions a partition reads stay in the scratchpad up to the slot
+		//it lands in; held are the producers of those values. A later slot only lengthens their
+		//stay, so a slot that overflows the cap rules out the rest and the merge fails there.
+		vector<int> held;
+		auto scratchOverflow = [&](int s) {
+			if(lim.spSize == INT_MAX) return -1;
+			vector<int> add(s + 2, 0);
+			for(int u : held) {
+				if(lastUse[u] < s) {
+					add[lastUse[u] + 1]++;
+					add[s + 1]--;
+				}
+			}
+			for(int l = 0, run = 0; l <= s; l++) {
+				run += add[l];
+				if(run > 0 && (l < (int)slots.size() ? slots[l].resident : 0) + run > lim.spSize) return l;
+			}
+			return -1;
+		};
+		//read budget of slot s with partition q of the piece added; pipelined, the loads of a slot
+		//are prefetched during the slot before it (see PartEval), so both neighbours take part
+		auto fitsReads = [&](int s, int q) {
+			int reads = (s < (int)slots.size() ? slots[s].reads : 0) + counts[q].reads;
+			int loads = (s < (int)slots.size() ? slots[s].loads : 0) + counts[q].loads;
+			if(!lim.pipelined) return reads + loads <= lim.TSize;
+			int nextLoads = s + 1 < (int)slots.size() ? slots[s + 1].loads : 0;
+			int prevReads = s > 0 ? slots[s - 1].reads : 0;
+			return reads + nextLoads <= lim.TSize && prevReads + loads <= lim.TSize;
+		};
+		vector<vector<int>> members(sp.numParts); //vertices of the graph in each partition of the piece
+		for(int i = 0; i < sp.numReal; i++) {
+			members[sp.part[i]].push_back(sp.origIds[i]);
+		}
+
+		//place each partition of the piece in the first later merged partition it fits in
+		int last = minSlot[p] - 1;
+		for(int q = 0; q < sp.numParts; q++) {
+			if(counts[q].size == 0) continue;
+			held.clear();
+			stamp++;
+			for(int v : members[q]) {
+				for(int u : preds[v]) {
+					if(part[u] >= 0 && seen[u] != stamp) {
+						seen[u] = stamp;
+						held.push_back(u);
+					}
+				}
+			}
+			int s = last + 1;
+			for(; s < (int)slots.size(); s++) {
+				partCounts &sc = slots[s];
+				if(sc.size + counts[q].size <= lim.RSize && fitsReads(s, q) &&
+				   sc.writes + sc.stores + counts[q].writes + counts[q].stores <= lim.TSize && fitsClasses(s, q)) {
+					break;
+				}
+			}
+			if(s == (int)slots.size() && !fitsReads(s, q)) {
+				s++; //pipelined: the last slot cannot prefetch q, an empty partition in between does
+			}
+			int over = scratchOverflow(s);
+			if(over >= 0) {
+				cout << "Merging piece " << p << " overflows the scratchpad in partition " << over << endl;
+				return -1;
+			}
+			while(s >= (int)slots.size()) {
+				slots.push_back(partCounts{0, 0, 0, 0, 0, 0, 0, 0});
+				slotClass.resize(slotClass.size() + nc, 0);
+			}
+			for(int c = 0; c < nc; c++) {
+				slotClass[(size_t)s * nc + c] += pieceClass[(size_t)q * nc + c];
+			}
+			slots[s].size += counts[q].size;
+			slots[s].reads += counts[q].reads;
+			slots[s].writes += counts[q].writes;
+			slots[s].loads += counts[q].loads;
+			slots[s].stores += counts[q].stores;
+			for(int u : held) {
+				for(int l = lastUse[u] + 1; l <= s; l++) {
+					slots[l].resident++;
+				}
+				lastUse[u] = max(lastUse[u], s);
+			}
+			for(int v : members[q]) {
+				part[v] = s;
+				lastUse[v] = s;
+			}
+			last = s;
+		}
+		for(int q : pieceSuccs[p]) {
+			minSlot[q] = max(minSlot[q], last + 1);
+			if(--indeg[q] == 0) ready.push(q);
+		}
+	}
+	if(done != np) {
+		cout << "Pieces do not form a DAG" << endl;
+		return -1;
+	}
+
+	int numParts = slots.size();
+	vector<partCounts> counts;
+	string err = eval.validate(part, numParts, counts);
+	if(!err.empty()) {
+		cout << "Merged assignment invalid: " << err << endl;
+		return -1;
+	}
+	return numParts;
+}
@@ -0,0 +1,232 @@
+#include "DFGGen.h"
+#include "DFGUtils.h"
+
+DFGGen::DFGGen(unsigned seed, int grpSize) : rng(seed) {
+	groupSize = max(1, grpSize);
+}
+
+//operation mix of the Express kernels
+string DFGGen::randOp() {
+	static const char *ops[] = {"ADD", "ADD", "ADD", "SUB", "MUL", "MUL", "AND", "ASR", "LSR"};
+	return ops[rand(sizeof(ops) / sizeof(ops[0]))];
+}
+
+int DFGGen::addNode(const string &lbl) {
+	labels.push_back(lbl);
+	return labels.size() - 1;
+}
+
+int DFGGen::addLoad() {
+	if(loadGroup < 0 || loadFill == groupSize) {
+		loadGroup = nextGroup++;
+		loadFill = 0;
+	}
+	loadFill++;
+	return addNode("LOD;" + to_string(loadGroup));
+}
+
+int DFGGen::addStore(int src) {
+	if(storeGroup < 0 || storeFill == groupSize) {
+		storeGroup = nextGroup++;
+		storeFill = 0;
+	}
+	storeFill++;
+	int st = addNode("STR;" + to_string(storeGroup));
+	addEdge(src, st);
+	return st;
+}
+
+void DFGGen::closeGroups() {
+	loadGroup = storeGroup = -1;
+}
+
+int DFGGen::sum(vector<int> vals, int arity) {
+	if(vals.empty()) throw string("ADD tree over no values");
+	arity = max(2, arity);
+	while(vals.size() > 1) {
+		vector<int> next;
+		for(size_t i = 0; i < vals.size(); i += arity) {
+			size_t end = min(vals.size(), i + arity);
+			if(end - i == 1) {
+				next.push_back(vals[i]);
+				continue;
+			}
+			int nd = addNode("ADD");
+			for(size_t j = i; j < end; j++) addEdge(vals[j], nd);
+			next.push_back(nd);
+		}
+		vals.swap(next);
+	}
+	return vals[0];
+}
+
+void DFGGen::layered(int layers, int width, int fanin, int skipPct) {
+	if(layers < 1 || width < 1 || fanin < 1) throw string("layered needs at least one layer, node and operand");
+	closeGroups();
+	int first = labels.size();
+	vector<int> prev;
+	for(int w = 0; w < width; w++) prev.push_back(addLoad());
+	for(int l = 1; l < layers; l++) {
+		int layerStart = labels.size();
+		vector<int> cur;
+		for(int w = 0; w < width; w++) {
+			int nd = addNode(randOp());
+			vector<int> ops;
+			for(int f = 0; f < fanin; f++) {
+				int src = rand(100) < skipPct ? first + rand(layerStart - first) : prev[rand(prev.size())];
+				if(find(ops.begin(), ops.end(), src) == ops.end()) ops.push_back(src);
+			}
+			for(int src : ops) addEdge(src, nd);
+			cur.push_back(nd);
+		}
+		prev.swap(cur);
+	}
+	closeGroups();
+	for(int nd : prev) addStore(nd);
+}
+
+void DFGGen::fft(int logn) {
+	if(logn < 0 || logn > 30) throw string("fft needs 0 to 30 for log2 of the points");
+	closeGroups();
+	int n = 1 << logn;
+	vector<int> x(n);
+	for(int i = 0; i < n; i++) x[i] = addLoad();
+	for(int s = 0; s < logn; s++) {
+		int half = 1 << s;
+		for(int blk = 0; blk < n; blk += 2 * half) {
+			for(int j = blk; j < blk + half; j++) {
+				int tw = addNode("MUL"); //twiddle factor times the odd input
+				addEdge(x[j + half], tw);
+				int sum = addNode("ADD");
+				int diff = addNode("SUB");
+				addEdge(x[j], sum);
+				addEdge(tw, sum);
+				addEdge(x[j], diff);
+				addEdge(tw, diff);
+				x[j] = sum;
+				x[j + half] = diff;
+			}
+		}
+	}
+	closeGroups();
+	for(int nd : x) addStore(nd);
+}
+
+void DFGGen::stencil(int width, int height, int steps) {
+	vector<vector<int>> grid(height, vector<int>(width));
+	for(int y = 0; y < height; y++) {
+		closeGroups(); //a group never spans two rows
+		for(int x = 0; x < width; x++) grid[y][x] = addLoad();
+	}
+	const int dx[] = {0, -1, 1, 0, 0}, dy[] = {0, 0, 0, -1, 1};
+	for(int s = 0; s < steps; s++) {
+		vector<vector<int>> next(height, vector<int>(width));
+		for(int y = 0; y < height; y++) {
+			for(int x = 0; x < width; x++) {
+				vector<int> nbrs;
+				for(int d = 0; d < 5; d++) {
+					int nx = x + dx[d], ny = y + dy[d];
+					if(nx >= 0 && nx < width && ny >= 0 && ny < height) nbrs.push_back(grid[ny][nx]);
+				}
+				int scale = addNode("MUL");
+				addEdge(sum(nbrs, 2), scale);
+				next[y][x] = scale;
+			}
+		}
+		grid.swap(next);
+	}
+	for(int y = 0; y < height; y++) {
+		closeGroups();
+		for(int x = 0; x < width; x++) addStore(grid[y][x]);
+	}
+}
+
+void DFGGen::reduce(int n, int arity) {
+	closeGroups();
+	vector<int> vals;
+	for(int i = 0; i < n; i++) vals.push_back(addLoad());
+	closeGroups();
+	addStore(sum(vals, arity));
+}
+
+void DFGGen::matmul(int m, int n, int k) {
+	vector<vector<int>> a(m, vector<int>(k)), b(k, vector<int>(n));
+	for(int i = 0; i < m; i++) {
+		closeGroups(); //rows of A
+		for(int l = 0; l < k; l++) a[i][l] = addLoad();
+	}
+	for(int j = 0; j < n; j++) {
+		closeGroups(); //columns of B
+		for(int l = 0; l < k; l++) b[l][j] = addLoad();
+	}
+	for(int i = 0; i < m; i++) {
+		closeGroups(); //rows of C
+		for(int j = 0; j < n; j++) {
+			vector<int> prods;
+			for(int l = 0; l < k; l++) {
+				int p = addNode("MUL");
+				addEdge(a[i][l], p);
+				addEdge(b[l][j], p);
+				prods.push_back(p);
+			}
+			addStore(sum(prods, 2));
+		}
+	}
+}
+
+void DFGGen::replicate(DAG &kernel, int copies) {
+	for(int c = 0; c < copies; c++) {
+		map<uint32_t, int> idMap;
+		map<int, int> grpMap; //group of the kernel -> group of this copy
+		for(list<Node>::iterator it = kernel.nodeBegin(); it != kernel.nodeEnd(); it++) {
+			string lbl = it->getLabel();
+			//LOD;g and STR;g name a group, load;s and store;s a stride that stays as it is
+			if(lbl.compare(0, 4, "LOD;") == 0 || lbl.compare(0, 4, "STR;") == 0) {
+				int g = getMemGroup(lbl);
+				if(grpMap.find(g) == grpMap.end()) grpMap[g] = nextGroup++;
+				lbl = lbl.substr(0, 4) + to_string(grpMap[g]);
+			}
+			idMap[it->getID()] = addNode(lbl);
+		}
+		for(list<Edge>::iterator it = kernel.edgeBegin(); it != kernel.edgeEnd(); it++) {
+			addEdge(idMap[it->getSrcNodeID()], idMap[it->getDestNodeID()]);
+		}
+	}
+	closeGroups();
+}
+
+void DFGGen::storeSinks() {
+	int n = labels.size();
+	vector<char> hasSucc(n, 0);
+	for(auto &e : edges) hasSucc[e.first] = 1;
+	closeGroups();
+	for(int v = 0; v < n; v++) {
+		if(!hasSucc[v] && !isStoreOp(labels[v])) addStore(v);
+	}
+}
+
+void DFGGen::write(const string &fname) const {
+	ofstream out(fname);
+	if(!out) {
+		throw string("Cannot write ") + fname;
+	}
+	out << "digraph  {\n";
+	for(size_t v = 0; v < labels.size(); v++) {
+		out << "   " << v << " [label=\"" << labels[v] << "\"];\n";
+	}
+	for(auto &e : edges) {
+		out << "   " << e.first << "->" << e.second << " [label=\"1:1\"];\n";
+	}
+	out << "}\n";
+}
+
+DAG DFGGen::toDAG() const {
+	DAG gp;
+	for(size_t v = 0; v < labels.size(); v++) {
+		gp.addNode(v, labels[v]);
+	}
+	for(size_t e = 0; e < edges.size(); e++) {
+		gp.addEdge(e, edges[e].first, edges[e].second, "1:1");
+	}
+	return gp;
+}
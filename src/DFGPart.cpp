@@ -1,7 +1,8 @@
 #include "DFGPart.h"
 #include "DFGAnaly.h"
-DFGPart::DFGPart(DAG grph) {
+DFGPart::DFGPart(DAG grph, const partLimits &lim, const LatencyTable &latencies) : fu(lim.fu), latTable(latencies) {
 	gp = grph;
+	SPSize = lim.spSize;
 }
 
 vector<vector<int>> DFGPart::getCombs(int timeMax, int k) {
@@ -26,29 +27,55 @@ vector<vector<int>> DFGPart::getCombs(int timeMax, int k) {
 	return combs;
 }
 
-partData DFGPart::getInterNds(int start, int end, vector<int> &timeSt) {
-	uint32_t total = 0, out = 0;
-	partData pData;
-	for(uint32_t nd = 0; nd < timeSt.size(); nd++) {
-		if(timeSt[nd] >= start && timeSt[nd] <= end) {
-			list<Node> succs;
-			string label = gp.findNode(nd)->getLabel();
-			total++;
-			gp.getSuccessors(nd, succs);
-			bool outYes = false;
-			for(Node nd : succs) {
-				if(timeSt[nd.getID()] > end) {
-					outYes = true;
-					break;
-				}
-			}
-			if(outYes == true) {
-				out++;
-			}
+//one row per time step, so the counts of any range of steps are a few popcounts
+void DFGPart::levelMasks(vector<int32_t> &timeSt, int timeMax) {
+	int n = timeSt.size();
+	vector<int32_t> lastUse(timeSt); //time of the last successor, a value is dead after it
+	for(list<Edge>::iterator it = gp.edgeBegin(); it != gp.edgeEnd(); it++) {
+		int src = it->getSrcNodeID();
+		lastUse[src] = max(lastUse[src], timeSt[it->getDestNodeID()]);
+	}
+	BitMatrix dead(timeMax + 1, n);
+	upTo.assign(timeMax + 1, n);
+	for(int nd = 0; nd < n; nd++) {
+		upTo.set(timeSt[nd], nd);
+		dead.set(lastUse[nd], nd);
+	}
+	size_t W = upTo.rowWords();
+	live = upTo;
+	for(int t = 1; t <= timeMax; t++) {
+		orWords(upTo.row(t), upTo.row(t - 1), W);
+		orWords(dead.row(t), dead.row(t - 1), W);
+		copy(upTo.row(t), upTo.row(t) + W, live.row(t));
+		xorWords(live.row(t), dead.row(t), W); //dead vertices are a subset of upTo
+	}
+	if(fu.limited()) {
+		classMasks.assign(fu.numClasses(), n);
+		for(list<Node>::iterator it = gp.nodeBegin(); it != gp.nodeEnd(); it++) {
+			classMasks.set(fu.classOf(it->getLabel()), it->getID());
 		}
 	}
-	pData.total = total;
-	pData.out = out;
+}
+
+bool DFGPart::fitsClasses(int start, int end) {
+	if(!fu.limited()) {
+		return true;
+	}
+	size_t W = upTo.rowWords();
+	for(int c = 0; c < fu.numClasses(); c++) {
+		int cnt = popcountAnd(classMasks.row(c), upTo.row(end), W) - popcountAnd(classMasks.row(c), upTo.row(start - 1), W);
+		if(cnt > fu.getCapacity(c)) return false;
+	}
+	return true;
+}
+
+partData DFGPart::getInterNds(int start, int end, vector<int> &timeSt) {
+	size_t W = upTo.rowWords();
+	const uint64_t *before = upTo.row(start - 1);
+	partData pData;
+	pData.total = upTo.count(end) - popcountWords(before, W);
+	pData.out = live.count(end) - popcountAnd(live.row(end), before, W);
+	pData.resident = live.count(start - 1);
 	return pData;
 }
 
@@ -63,23 +90,43 @@ int DFGPart::printParts(vector<partDef>& AllParts) {
 	cout << " Total coast = " << totalCoast << endl;
 	return totalCoast;
 }
+vector<int> DFGPart::assignOf(const vector<partDef> &parts, vector<int32_t> &timeSt) {
+	vector<int> as(timeSt.size(), -1);
+	for(uint32_t nd = 0; nd < timeSt.size(); nd++) {
+		for(int p = 0; p < (int)parts.size(); p++) {
+			if(timeSt[nd] >= parts[p].start && timeSt[nd] <= parts[p].end) {
+				as[nd] = p;
+			}
+		}
+	}
+	return as;
+}
+
 int DFGPart::partitionDFGnP(int npart, int map_size) {
 	DFGAnaly danl = DFGAnaly(gp);
+	danl.setLatencies(latTable);
 	vector<uint32_t> topOrder = danl.topoSort();
 	vector<int32_t> timeSt; 
 	int applicableParts = 0;
 	int32_t timeMax = danl.assignTime(topOrder, timeSt);
-	vector<vector<int>> combs = getCombs(timeMax, npart - 1);
+	levelMasks(timeSt, timeMax);
+	//split only after finish cycles some vertex has, latencies above one leave the others empty
+	vector<int32_t> steps(timeSt);
+	sort(steps.begin(), steps.end());
+	steps.erase(unique(steps.begin(), steps.end()), steps.end());
+	vector<vector<int>> combs = getCombs(steps.size(), npart - 1);
 	vector<partDef> selectedMin;
 	int minCoast = INT_MAX;
+	double minTime = DBL_MAX;
 	for(vector<int> splits: combs) {
 		int prev = 1;
 		int totalCoast = 0; //for total intermediate outputs
 		vector<partDef> AllParts;
-		splits.push_back(timeMax);
-		for(int split : splits) {
+		splits.push_back(steps.size());
+		for(int step : splits) {
+			int split = steps[step - 1];
 			partData pData = getInterNds(prev, split, timeSt);
-			if(pData.total > map_size) {
+			if(pData.total > map_size || pData.resident > SPSize || !fitsClasses(prev, split)) {
 				break;
 			}
 			partDef pd;
@@ -92,7 +139,16 @@ int DFGPart::partitionDFGnP(int npart, int map_size) {
 		if(AllParts.size() == npart) {
 			totalCoast = printParts(AllParts);
 			applicableParts++;
-			if(totalCoast < minCoast) {
+			if(perf != NULL) {
+				double time = perf->estimate(assignOf(AllParts, timeSt), npart).batchCycles;
+				cout << " Estimated cycles " << time << endl;
+				if(time < minTime || (time == minTime && totalCoast < minCoast)) {
+					selectedMin = AllParts;
+					minCoast = totalCoast;
+					minTime = time;
+				}
+			}
+			else if(totalCoast < minCoast) {
 				selectedMin = AllParts;
 				minCoast = totalCoast;
 			}
@@ -102,18 +158,21 @@ int DFGPart::partitionDFGnP(int npart, int map_size) {
 	if(applicableParts) {
 		cout << "Choosen min total coast partition ";
 		printParts(selectedMin);
+		assign = assignOf(selectedMin, timeSt);
 	}
 	return applicableParts;
 }
 
-void DFGPart::partitionDFGVar(int map_size) {
+//returns the number of partitions found, 0 if none up to 10
+int DFGPart::partitionDFGVar(int map_size) {
 	for(int nparts = 2; nparts <= 10; nparts++) {
 		cout << "Trying with " << nparts << endl;
 		if(partitionDFGnP(nparts, map_size)) {
 			cout << "Success\n" << endl;
-			break;
+			return nparts;
 		}
 	}
+	return 0;
 }
 
 
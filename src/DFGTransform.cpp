@@ -0,0 +1,274 @@
+#include "DFGTransform.h"
+#include "DFGUtils.h"
+
+//dense index of every node id, -1 for ids not in the graph
+static vector<int> denseIndex(DAG &dfg) {
+	vector<int> idx(dfg.getNumNodes() == 0 ? 0 : dfg.getMaxNodeID() + 1, -1);
+	int n = 0;
+	for(auto it = dfg.nodeBegin(); it != dfg.nodeEnd(); ++it) {
+		idx[it->getID()] = n++;
+	}
+	return idx;
+}
+
+//edge of a pass result: id, source, destination and label
+typedef tuple<uint32_t, int, int, string> flatEdge;
+
+//the one DAG a pass builds, nodes 0..V-1 with the given labels; the only step that goes through
+//addNode/addEdge, whose id checks make it quadratic in the Graph library
+static DAG buildDAG(const vector<string> &labels, const vector<flatEdge> &edges) {
+	DAG newDfg;
+	for(size_t v = 0; v < labels.size(); v++) {
+		newDfg.addNode(v, labels[v]);
+	}
+	for(auto &e : edges) {
+		newDfg.addEdge(get<0>(e), get<1>(e), get<2>(e), get<3>(e));
+	}
+	return newDfg;
+}
+
+//copy of dfg without the nodes marked in drop, surviving nodes renumbered densely
+static DAG compact(DAG &dfg, const vector<int> &idx, const vector<bool> &drop) {
+	vector<int> newId(drop.size(), -1);
+	vector<string> labels;
+	for(auto it = dfg.nodeBegin(); it != dfg.nodeEnd(); ++it) {
+		int v = idx[it->getID()];
+		if(drop[v]) continue;
+		newId[v] = labels.size();
+		labels.push_back(it->getLabel());
+	}
+	vector<flatEdge> edges;
+	for(auto it = dfg.edgeBegin(); it != dfg.edgeEnd(); ++it) {
+		int src = idx[it->getSrcNodeID()], dest = idx[it->getDestNodeID()];
+		if(!drop[src] && !drop[dest]) {
+			edges.push_back(make_tuple(it->getID(), newId[src], newId[dest], it->getLabel()));
+		}
+	}
+	return buildDAG(labels, edges);
+}
+
+//predecessors of every dense index in CSR form
+static void predCSR(DAG &dfg, const vector<int> &idx, vector<int> &predBeg, vector<int> &predList) {
+	int n = dfg.getNumNodes();
+	predBeg.assign(n + 1, 0);
+	predList.resize(dfg.getNumEdges());
+	for(auto it = dfg.edgeBegin(); it != dfg.edgeEnd(); ++it) {
+		predBeg[idx[it->getDestNodeID()] + 1]++;
+	}
+	for(int v = 0; v < n; v++) predBeg[v + 1] += predBeg[v];
+	vector<int> fill(predBeg.begin(), predBeg.end() - 1);
+	for(auto it = dfg.edgeBegin(); it != dfg.edgeEnd(); ++it) {
+		predList[fill[idx[it->getDestNodeID()]]++] = idx[it->getSrcNodeID()];
+	}
+}
+
+DAG convertDOT(const string &fname) {
+	ifstream dfIn(fname);
+	if(dfIn.fail()) throw (string("fromDOT: unable to open input file ") + fname);
+
+	//header, the graph name is optional
+	string line, s;
+	getline(dfIn, line);
+	stringstream header(line);
+	header >> s;
+	if(s != "digraph") throw (string("fromDOT: invalid graph type for this graph"));
+	header >> s;
+	if(s != "{") header >> s;
+	if(s != "{") throw (string("fromDOT: syntax error, expected \"{\" after graph name, found " + s));
+
+	DAG gp;
+	map<string, int> nodeMapper;
+	int edgeCount = 0;
+	while(getline(dfIn, line)) {
+		stringstream s_stream(line);
+		if(s_stream.peek() == '}') break;
+		string node_id;
+		s_stream >> node_id;
+		if(s_stream.fail()) continue; //blank line
+		if(node_id == "}") break;
+		s_stream >> s;
+		if(s == "[label") {
+			string op_code;
+			s_stream >> s >> op_code; //= sign, then the op
+			int id = nodeMapper.size();
+			nodeMapper[node_id] = id;
+			gp.addNode(id, op_code);
+		}
+		else if(s == "->") {
+			string dest_id;
+			s_stream >> dest_id;
+			if(s_stream.fail()) throw (string("fromDOT: failed to get destination node id"));
+			if(dest_id.back() == ';') dest_id.pop_back();
+			if(nodeMapper.find(node_id) == nodeMapper.end() || nodeMapper.find(dest_id) == nodeMapper.end()) {
+				throw (string("fromDOT: edge between undeclared nodes ") + node_id + " " + dest_id);
+			}
+			gp.addEdge(edgeCount++, nodeMapper[node_id], nodeMapper[dest_id], "1:1");
+		}
+		else if(s.find("[fontcolor") == string::npos) { //fontcolor lines are skipped
+			throw (string("fromDOT: syntax error, expected a node or an edge"));
+		}
+	}
+	return gp;
+}
+
+DAG normalize(DAG &dfg) {
+	vector<int> idx = denseIndex(dfg);
+	return compact(dfg, idx, vector<bool>(dfg.getNumNodes(), false));
+}
+
+DAG eliminateDead(DAG &dfg) {
+	vector<int> idx = denseIndex(dfg);
+	int n = dfg.getNumNodes();
+	vector<int> predBeg, predList;
+	predCSR(dfg, idx, predBeg, predList);
+
+	//live: stores and everything they depend on
+	vector<bool> drop(n, true);
+	vector<int> stk;
+	for(auto it = dfg.nodeBegin(); it != dfg.nodeEnd(); ++it) {
+		if(isStoreOp(it->getLabel())) {
+			drop[idx[it->getID()]] = false;
+			stk.push_back(idx[it->getID()]);
+		}
+	}
+	if(stk.empty()) {
+		return normalize(dfg);
+	}
+	for(size_t s = 0; s < stk.size(); s++) {
+		int v = stk[s];
+		for(int k = predBeg[v]; k < predBeg[v + 1]; k++) {
+			int u = predList[k];
+			if(drop[u]) {
+				drop[u] = false;
+				stk.push_back(u);
+			}
+		}
+	}
+	return compact(dfg, idx, drop);
+}
+
+DAG loadSanitize(DAG &dfg) {
+	vector<int> idx = denseIndex(dfg);
+	int n = dfg.getNumNodes();
+	vector<int> predBeg, predList;
+	predCSR(dfg, idx, predBeg, predList);
+
+	//one reverse sweep from all loads at once, every ancestor is marked and expanded once
+	vector<bool> drop(n, false);
+	vector<int> stk;
+	for(auto it = dfg.nodeBegin(); it != dfg.nodeEnd(); ++it) {
+		if(it->getLabel().find("LOD") != string::npos) stk.push_back(idx[it->getID()]);
+	}
+	for(size_t s = 0; s < stk.size(); s++) {
+		int v = stk[s];
+		for(int k = predBeg[v]; k < predBeg[v + 1]; k++) {
+			int u = predList[k];
+			if(!drop[u]) {
+				drop[u] = true;
+				stk.push_back(u);
+			}
+		}
+	}
+	return compact(dfg, idx, drop);
+}
+
+DAG renumber(DAG &dfg, const string &order, vector<int> &origId) {
+	vector<int> idx = denseIndex(dfg);
+	int n = dfg.getNumNodes();
+	vector<uint32_t> ids(n);
+	vector<string> labels(n);
+	for(auto it = dfg.nodeBegin(); it != dfg.nodeEnd(); ++it) {
+		int v = idx[it->getID()];
+		ids[v] = it->getID();
+		labels[v] = it->getLabel();
+	}
+	vector<vector<int>> succs(n), nbrs(n);
+	vector<int> indeg(n, 0);
+	for(auto it = dfg.edgeBegin(); it != dfg.edgeEnd(); ++it) {
+		int src = idx[it->getSrcNodeID()], dest = idx[it->getDestNodeID()];
+		succs[src].push_back(dest);
+		nbrs[src].push_back(dest);
+		nbrs[dest].push_back(src);
+		indeg[dest]++;
+	}
+
+	//topological order, breadth first from the sources in input order
+	vector<int> perm; //new -> dense input index
+	for(int v = 0; v < n; v++) {
+		if(indeg[v] == 0) perm.push_back(v);
+	}
+	vector<int> level(n, 0);
+	for(int h = 0; h < (int)perm.size(); h++) {
+		int v = perm[h];
+		for(int s : succs[v]) {
+			level[s] = max(level[s], level[v] + 1);
+			if(--indeg[s] == 0) perm.push_back(s);
+		}
+	}
+	if((int)perm.size() != n) throw string("renumber: the graph has a cycle");
+
+	if(order == "level") {
+		stable_sort(perm.begin(), perm.end(), [&](int a, int b) {return level[a] < level[b];});
+	}
+	else if(order == "rcm") {
+		vector<int> deg(n);
+		for(int v = 0; v < n; v++) {
+			sort(nbrs[v].begin(), nbrs[v].end());
+			nbrs[v].erase(unique(nbrs[v].begin(), nbrs[v].end()), nbrs[v].end());
+			deg[v] = nbrs[v].size();
+		}
+		auto byDeg = [&](int a, int b) {return deg[a] != deg[b] ? deg[a] < deg[b] : a < b;};
+		vector<int> starts(n);
+		iota(starts.begin(), starts.end(), 0);
+		sort(starts.begin(), starts.end(), byDeg); //each component starts from its lowest degree node
+		vector<bool> seen(n, false);
+		perm.clear();
+		for(int st : starts) {
+			if(seen[st]) continue;
+			seen[st] = true;
+			perm.push_back(st);
+			for(size_t h = perm.size() - 1; h < perm.size(); h++) {
+				vector<int> next;
+				for(int u : nbrs[perm[h]]) {
+					if(!seen[u]) {
+						seen[u] = true;
+						next.push_back(u);
+					}
+				}
+				sort(next.begin(), next.end(), byDeg);
+				perm.insert(perm.end(), next.begin(), next.end());
+			}
+		}
+		reverse(perm.begin(), perm.end());
+	}
+	else if(order != "bfs") {
+		throw string("renumber: unknown order ") + order;
+	}
+
+	vector<int> newId(n);
+	vector<string> newLabels(n);
+	origId.resize(n);
+	for(int v = 0; v < n; v++) {
+		newId[perm[v]] = v;
+		origId[v] = ids[perm[v]];
+		newLabels[v] = labels[perm[v]];
+	}
+	vector<flatEdge> edges;
+	for(auto it = dfg.edgeBegin(); it != dfg.edgeEnd(); ++it) {
+		edges.push_back(make_tuple(0, newId[idx[it->getSrcNodeID()]], newId[idx[it->getDestNodeID()]], it->getLabel()));
+	}
+	sort(edges.begin(), edges.end());
+	for(size_t e = 0; e < edges.size(); e++) {
+		get<0>(edges[e]) = e;
+	}
+	return buildDAG(newLabels, edges);
+}
+
+vector<int> restoreOrder(const vector<int> &vals, const vector<int> &origId) {
+	if(origId.empty()) return vals;
+	vector<int> orig(vals.size());
+	for(size_t v = 0; v < vals.size(); v++) {
+		orig[origId[v]] = vals[v];
+	}
+	return orig;
+}
@@ -0,0 +1,62 @@
+#include "DFGUtils.h"
+#include <fstream>
+#include <algorithm>
+#include <dirent.h>
+
+bool isLoadOp(const string &op) {
+	return op.find("load") != string::npos || op.find("LOD") != string::npos; ///two possible vals for describing load nodes
+}
+
+bool isStoreOp(const string &op) {
+	return op.find("store") != string::npos || op.find("STR") != string::npos; ///two possible vals for describing store nodes
+}
+
+int getMemGroup(const string &op) {
+	int pos = op.find(";");
+	return stoi(op.substr(pos + 1, string::npos)); //from ; + 1 till end of string
+}
+
+string opcodeOf(const string &label) {
+	string op = label.substr(0, min(label.find(';'), label.find(']')));
+	transform(op.begin(), op.end(), op.begin(), ::tolower);
+	if(op == "lod") return "load";
+	if(op == "str") return "store";
+	return op;
+}
+
+void hashBytes(uint64_t &h, const void *data, size_t len) {
+	const unsigned char *p = (const unsigned char *)data;
+	for(size_t i = 0; i < len; i++) {
+		h ^= p[i];
+		h *= 1099511628211ULL;
+	}
+}
+
+uint64_t hashString(const string &s) {
+	uint64_t h = FNV_OFFSET;
+	hashBytes(h, s.data(), s.size());
+	return h;
+}
+
+void collectDotFiles(const string &entry, vector<string> &files) {
+	if(entry.size() > 4 && entry.substr(entry.size() - 4) == ".dot") {
+		files.push_back(entry);
+	}
+	else if(DIR *dp = opendir(entry.c_str())) {
+		vector<string> found;
+		while(struct dirent *de = readdir(dp)) {
+			string f = de->d_name;
+			if(f.size() > 4 && f.substr(f.size() - 4) == ".dot") found.push_back(entry + "/" + f);
+		}
+		closedir(dp);
+		sort(found.begin(), found.end());
+		files.insert(files.end(), found.begin(), found.end());
+	}
+	else {
+		ifstream in(entry);
+		string line;
+		while(getline(in, line)) {
+			if(!line.empty() && line[0] != '#') files.push_back(line);
+		}
+	}
+}
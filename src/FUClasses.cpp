@@ -0,0 +1,107 @@
+#include "FUClasses.h"
+#include "DFGCoarsen.h"
+#include "DFGUtils.h"
+
+FUClasses::FUClasses() {
+	names.push_back("any");
+	capacity.push_back(INT_MAX);
+}
+
+bool FUClasses::load(const string &fname) {
+	ifstream in(fname);
+	if(!in) {
+		return false;
+	}
+	string line;
+	while(getline(in, line)) {
+		istringstream ls(line.substr(0, line.find('#')));
+		string name, op;
+		int cap;
+		if(!(ls >> name)) continue;
+		if(!(ls >> cap)) {
+			throw string("Bad FU class line: ") + line;
+		}
+		vector<string> ops;
+		while(ls >> op) ops.push_back(op);
+		addClass(name, cap, ops);
+	}
+	return true;
+}
+
+void FUClasses::addClass(const string &name, int cap, const vector<string> &ops) {
+	int c = find(names.begin(), names.end(), name) - names.begin();
+	if(c == (int)names.size()) {
+		names.push_back(name);
+		capacity.push_back(cap);
+	}
+	else {
+		capacity[c] = cap;
+	}
+	for(string op : ops) {
+		classOfOp[opcodeOf(op)] = c;
+	}
+}
+
+bool FUClasses::limited() const {
+	return *min_element(capacity.begin(), capacity.end()) < INT_MAX;
+}
+
+string FUClasses::tag() const {
+	if(!limited()) {
+		return "";
+	}
+	string desc;
+	for(size_t c = 0; c < names.size(); c++) {
+		desc += names[c] + "=" + to_string(capacity[c]) + ";";
+	}
+	for(auto &kv : classOfOp) {
+		desc += kv.first + ":" + to_string(kv.second) + ";";
+	}
+	char hex[17];
+	snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)hashString(desc));
+	return hex;
+}
+
+int FUClasses::classOf(const string &label) const {
+	map<string, int>::const_iterator it = classOfOp.find(opcodeOf(label));
+	return it == classOfOp.end() ? 0 : it->second;
+}
+
+vector<int> FUClasses::usage(DAG &gp) const {
+	int nc = names.size();
+	vector<int> use((size_t)gp.getNumNodes() * nc, 0);
+	for(list<Node>::iterator it = gp.nodeBegin(); it != gp.nodeEnd(); it++) {
+		use[(size_t)it->getID() * nc + classOf(it->getLabel())]++;
+	}
+	return use;
+}
+
+vector<int> FUClasses::usage(DFGCoarsen &cr) const {
+	int nc = names.size();
+	vector<int> orig = usage(cr.getOrigGraph());
+	vector<int> use(cr.getWeights().size() * nc, 0);
+	for(int v = 0; v < (int)orig.size() / nc; v++) {
+		for(int c = 0; c < nc; c++) {
+			use[(size_t)cr.getClusterOf(v) * nc + c] += orig[(size_t)v * nc + c];
+		}
+	}
+	return use;
+}
+
+string FUClasses::check(const vector<int> &use, const vector<int> &part, int numParts) const {
+	int nc = names.size();
+	vector<long> held((size_t)numParts * nc, 0);
+	for(size_t v = 0; v < part.size(); v++) {
+		for(int c = 0; c < nc; c++) {
+			held[(size_t)part[v] * nc + c] += use[v * nc + c];
+		}
+	}
+	for(int p = 0; p < numParts; p++) {
+		for(int c = 0; c < nc; c++) {
+			if(held[(size_t)p * nc + c] > capacity[c]) {
+				return "partition " + to_string(p) + " holds " + to_string(held[(size_t)p * nc + c]) + " " + names[c] + " vertices, capacity is " + to_string(capacity[c]);
+			}
+		}
+	}
+	return "";
+}
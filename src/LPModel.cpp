@@ -0,0 +1,400 @@
+#include "LPModel.h"
+#include <zlib.h>
+#include <cstdio>
+#include <cstring>
+
+#define OUT_BUF_SIZE (1 << 18)
+#define TERMS_PER_LINE 8 //keep LP lines short, some readers limit the line length
+
+//buffered writer on top of a plain or a gzip file
+class BufOut {
+	private:
+		FILE *fp = nullptr;
+		gzFile gz = nullptr;
+		vector<char> buf;
+		size_t len = 0;
+
+	public:
+		BufOut(string fname, bool compress) {
+			buf.resize(OUT_BUF_SIZE);
+			if(compress) {
+				gz = gzopen(fname.c_str(), "wb6");
+			}
+			else {
+				fp = fopen(fname.c_str(), "w");
+			}
+			if(fp == nullptr && gz == nullptr) throw (string("LPModel: unable to open output file ") + fname);
+		}
+
+		~BufOut() {
+			flush();
+			if(gz) gzclose(gz);
+			if(fp) fclose(fp);
+		}
+
+		void flush() {
+			if(len == 0) return;
+			if(gz) gzwrite(gz, buf.data(), len);
+			else fwrite(buf.data(), 1, len, fp);
+			len = 0;
+		}
+
+		void put(const char *s, size_t n) {
+			if(len + n > buf.size()) {
+				flush();
+				if(n > buf.size()) { //larger than the buffer, write through
+					if(gz) gzwrite(gz, s, n);
+					else fwrite(s, 1, n, fp);
+					return;
+				}
+			}
+			memcpy(buf.data() + len, s, n);
+			len += n;
+		}
+
+		void put(const char *s) {put(s, strlen(s));}
+		void put(const string &s) {put(s.data(), s.size());}
+		void put(char c) {
+			if(len == buf.size()) flush();
+			buf[len++] = c;
+		}
+
+		//integers are by far the most common coefficients, print those without snprintf
+		void num(double v) {
+			char tmp[32];
+			if(v == floor(v) && fabs(v) < 1e15) {
+				long long iv = (long long)v;
+				int n = 0;
+				bool neg = iv < 0;
+				unsigned long long uv = neg ? -iv : iv;
+				do {
+					tmp[n++] = '0' + uv % 10;
+					uv /= 10;
+				} while(uv);
+				if(neg) put('-');
+				while(n) put(tmp[--n]);
+				return;
+			}
+			int n = snprintf(tmp, sizeof(tmp), "%.15g", v);
+			put(tmp, n);
+		}
+};
+
+static bool endsWith(const string &s, const string &suf) {
+	return s.size() >= suf.size() && s.compare(s.size() - suf.size(), suf.size(), suf) == 0;
+}
+
+LPModel::LPModel(string nm) {
+	name = nm;
+	rowBeg.push_back(0);
+}
+
+void LPModel::clear() {
+	colName.clear();
+	colObj.clear();
+	colLo.clear();
+	colHi.clear();
+	colBin.clear();
+	rowName.clear();
+	rowLo.clear();
+	rowHi.clear();
+	rowBeg.clear();
+	rowInd.clear();
+	rowVal.clear();
+	rowBeg.push_back(0);
+}
+
+int LPModel::addCol(string nm, double obj, double lo, double hi, bool bin) {
+	colName.push_back(nm);
+	colObj.push_back(obj);
+	colLo.push_back(lo);
+	colHi.push_back(hi);
+	colBin.push_back(bin);
+	return colObj.size() - 1;
+}
+
+int LPModel::addBinCol(string nm, double obj) {
+	return addCol(nm, obj, 0, 1, true);
+}
+
+void LPModel::fixCol(int col, double val) {
+	colLo[col] = colHi[col] = val;
+	colBin[col] = 0;
+}
+
+void LPModel::setObj(int col, double val) {
+	colObj[col] = val;
+}
+
+int LPModel::beginRow(string nm, double lo, double hi) {
+	rowName.push_back(nm);
+	rowLo.push_back(lo);
+	rowHi.push_back(hi);
+	rowBeg.push_back(rowInd.size()); //empty row, grows with addCoef
+	return rowLo.size() - 1;
+}
+
+void LPModel::addCoef(int col, double val) {
+	if(val == 0) return;
+	rowInd.push_back(col);
+	rowVal.push_back(val);
+	rowBeg.back()++;
+}
+
+int LPModel::addRow(string nm, double lo, double hi, const vector<int> &ind, const vector<double> &val) {
+	int r = beginRow(nm, lo, hi);
+	for(size_t k = 0; k < ind.size(); k++) {
+		addCoef(ind[k], val[k]);
+	}
+	return r;
+}
+
+string LPModel::getColName(int c) const {
+	if(colName[c].empty()) return "c" + to_string(c);
+	return colName[c];
+}
+
+string LPModel::getRowName(int r) const {
+	if(rowName[r].empty()) return "r" + to_string(r);
+	return rowName[r];
+}
+
+void LPModel::write(string fname) {
+	bool gz = endsWith(fname, ".gz");
+	string base = gz ? fname.substr(0, fname.size() - 3) : fname;
+	if(endsWith(base, ".mps")) {
+		writeMPS(fname, gz);
+	}
+	else {
+		writeLP(fname, gz); //lp is the default format
+	}
+}
+
+void LPModel::writeLP(string fname, bool gz) {
+	BufOut out(fname, gz);
+	writeLPStream(&out);
+}
+
+void LPModel::writeMPS(string fname, bool gz) {
+	BufOut out(fname, gz);
+	writeMPSStream(&out);
+}
+
+//write one linear expression, wrapping lines every few terms
+static void putTerms(BufOut &out, const LPModel &lp, int beg, int end) {
+	int terms = 0;
+	for(int k = beg; k < end; k++) {
+		double v = lp.getVal(k);
+		out.put(v < 0 ? " - " : " + ");
+		if(fabs(v) != 1) {
+			out.num(fabs(v));
+			out.put(' ');
+		}
+		out.put(lp.getColName(lp.getInd(k)));
+		if(++terms % TERMS_PER_LINE == 0) out.put("\n ");
+	}
+}
+
+void LPModel::writeLPStream(void *o) {
+	BufOut &out = *(BufOut *)o;
+	out.put("\\Problem name: ");
+	out.put(name);
+	out.put("\n\nMinimize\n obj:");
+	int terms = 0;
+	for(int c = 0; c < getNumCols(); c++) {
+		if(colObj[c] == 0) continue;
+		out.put(colObj[c] < 0 ? " - " : " + ");
+		if(fabs(colObj[c]) != 1) {
+			out.num(fabs(colObj[c]));
+			out.put(' ');
+		}
+		out.put(getColName(c));
+		if(++terms % TERMS_PER_LINE == 0) out.put("\n ");
+	}
+	if(terms == 0 && getNumCols() > 0) { //empty objective still needs a term
+		out.put(" 0 ");
+		out.put(getColName(0));
+	}
+
+	out.put("\nSubject To\n");
+	for(int r = 0; r < getNumRows(); r++) {
+		int beg = rowBeg[r], end = rowBeg[r + 1];
+		//drop a side that is implied by the column bounds, LP format has no native ranges
+		double minAct = 0, maxAct = 0;
+		for(int k = beg; k < end; k++) {
+			double v = rowVal[k];
+			minAct += v > 0 ? v * colLo[rowInd[k]] : v * colHi[rowInd[k]];
+			maxAct += v > 0 ? v * colHi[rowInd[k]] : v * colLo[rowInd[k]];
+		}
+		bool hasLo = rowLo[r] > -LP_INF && rowLo[r] > minAct;
+		bool hasHi = rowHi[r] < LP_INF && rowHi[r] < maxAct;
+		if(rowLo[r] == rowHi[r]) {
+			hasLo = false;
+			hasHi = true;
+		}
+		if(!hasLo && !hasHi) continue; //redundant row
+
+		string nm = getRowName(r);
+		for(int side = 0; side < 2; side++) {
+			if(side == 0 && !hasLo) continue;
+			if(side == 1 && !hasHi) continue;
+			out.put(' ');
+			out.put(nm);
+			if(hasLo && hasHi && side == 1) out.put("_ub"); //ranged row split in two
+			out.put(':');
+			putTerms(out, *this, beg, end);
+			if(beg == end) {
+				out.put(" 0 ");
+				out.put(getColName(0));
+			}
+			if(side == 0) {
+				out.put(" >= ");
+				out.num(rowLo[r]);
+			}
+			else {
+				out.put(rowLo[r] == rowHi[r] ? " = " : " <= ");
+				out.num(rowHi[r]);
+			}
+			out.put('\n');
+		}
+	}
+
+	out.put("Bounds\n");
+	for(int c = 0; c < getNumCols(); c++) {
+		if(colBin[c]) continue;
+		out.put(' ');
+		if(colLo[c] <= -LP_INF) out.put("-inf");
+		else out.num(colLo[c]);
+		out.put(" <= ");
+		out.put(getColName(c));
+		out.put(" <= ");
+		if(colHi[c] >= LP_INF) out.put("+inf");
+		else out.num(colHi[c]);
+		out.put('\n');
+	}
+
+	out.put("Binaries\n");
+	terms = 0;
+	for(int c = 0; c < getNumCols(); c++) {
+		if(!colBin[c]) continue;
+		out.put(' ');
+		out.put(getColName(c));
+		if(++terms % TERMS_PER_LINE == 0) out.put('\n');
+	}
+	out.put("\nEnd\n");
+}
+
+void LPModel::writeMPSStream(void *o) {
+	BufOut &out = *(BufOut *)o;
+	int nrows = getNumRows();
+	int ncols = getNumCols();
+
+	out.put("NAME ");
+	out.put(name);
+	out.put("\nROWS\n N obj\n");
+	for(int r = 0; r < nrows; r++) {
+		if(rowLo[r] == rowHi[r]) out.put(" E ");
+		else if(rowLo[r] <= -LP_INF && rowHi[r] >= LP_INF) out.put(" N ");
+		else if(rowLo[r] <= -LP_INF) out.put(" L ");
+		else out.put(" G "); //lower bounded or ranged
+		out.put(getRowName(r));
+		out.put('\n');
+	}
+
+	//MPS is column major, transpose the row storage once
+	vector<int> colBeg(ncols + 1, 0);
+	for(int ind : rowInd) colBeg[ind + 1]++;
+	for(int c = 0; c < ncols; c++) colBeg[c + 1] += colBeg[c];
+	vector<int> colRow(rowInd.size());
+	vector<double> colVal(rowInd.size());
+	vector<int> pos(colBeg.begin(), colBeg.end() - 1);
+	for(int r = 0; r < nrows; r++) {
+		for(int k = rowBeg[r]; k < rowBeg[r + 1]; k++) {
+			int p = pos[rowInd[k]]++;
+			colRow[p] = r;
+			colVal[p] = rowVal[k];
+		}
+	}
+
+	out.put("COLUMNS\n");
+	for(int c = 0; c < ncols; c++) {
+		string nm = getColName(c);
+		if(colObj[c] != 0) {
+			out.put(' ');
+			out.put(nm);
+			out.put(" obj ");
+			out.num(colObj[c]);
+			out.put('\n');
+		}
+		for(int k = colBeg[c]; k < colBeg[c + 1]; k++) {
+			out.put(' ');
+			out.put(nm);
+			out.put(' ');
+			out.put(getRowName(colRow[k]));
+			out.put(' ');
+			out.num(colVal[k]);
+			out.put('\n');
+		}
+		if(colObj[c] == 0 && colBeg[c] == colBeg[c + 1]) { //keep empty columns in the model
+			out.put(' ');
+			out.put(nm);
+			out.put(" obj 0\n");
+		}
+	}
+
+	out.put("RHS\n");
+	for(int r = 0; r < nrows; r++) {
+		double rhs = rowLo[r] > -LP_INF ? rowLo[r] : rowHi[r];
+		if(rhs == 0 || rhs >= LP_INF) continue;
+		out.put(" RHS ");
+		out.put(getRowName(r));
+		out.put(' ');
+		out.num(rhs);
+		out.put('\n');
+	}
+
+	out.put("RANGES\n");
+	for(int r = 0; r < nrows; r++) {
+		if(rowLo[r] > -LP_INF && rowHi[r] < LP_INF && rowLo[r] != rowHi[r]) {
+			out.put(" RNG ");
+			out.put(getRowName(r));
+			out.put(' ');
+			out.num(rowHi[r] - rowLo[r]);
+			out.put('\n');
+		}
+	}
+
+	out.put("BOUNDS\n");
+	for(int c = 0; c < ncols; c++) {
+		string nm = getColName(c);
+		if(colBin[c]) {
+			out.put(" BV BND ");
+			out.put(nm);
+			out.put('\n');
+			continue;
+		}
+		if(colLo[c] <= -LP_INF && colHi[c] >= LP_INF) {
+			out.put(" FR BND ");
+			out.put(nm);
+			out.put('\n');
+			continue;
+		}
+		if(colLo[c] != 0) {
+			out.put(colLo[c] <= -LP_INF ? " MI BND " : " LO BND ");
+			out.put(nm);
+			if(colLo[c] > -LP_INF) {
+				out.put(' ');
+				out.num(colLo[c]);
+			}
+			out.put('\n');
+		}
+		if(colHi[c] < LP_INF) {
+			out.put(" UP BND ");
+			out.put(nm);
+			out.put(' ');
+			out.num(colHi[c]);
+			out.put('\n');
+		}
+	}
+	out.put("ENDATA\n");
+}
@@ -0,0 +1,346 @@
+#include "PartBnB.h"
+#include "DFGUtils.h"
+#include "ThreadPool.h"
+#include "ReachIndex.h"
+
+PartBnB::PartBnB(DAG &gp, const partLimits &lim) : bestCost(LONG_MAX), stopped(false), totalNodes(0) {
+	RSize = lim.RSize;
+	TSize = lim.TSize;
+	loadWeight = lim.loadWeight;
+	SPSize = lim.spSize;
+	hoistLoads = lim.pipelined;
+	numVertices = gp.getNumNodes();
+	succs.resize(numVertices);
+	preds.resize(numVertices);
+	for(list<Edge>::iterator it = gp.edgeBegin(); it != gp.edgeEnd(); it++) {
+		succs[it->getSrcNodeID()].push_back(it->getDestNodeID());
+		preds[it->getDestNodeID()].push_back(it->getSrcNodeID());
+	}
+	vector<int> indeg(numVertices);
+	for(int v = 0; v < numVertices; v++) {
+		sort(succs[v].begin(), succs[v].end());
+		succs[v].erase(unique(succs[v].begin(), succs[v].end()), succs[v].end());
+		sort(preds[v].begin(), preds[v].end());
+		preds[v].erase(unique(preds[v].begin(), preds[v].end()), preds[v].end());
+		indeg[v] = preds[v].size();
+		if(indeg[v] == 0) order.push_back(v);
+	}
+	for(int h = 0; h < (int)order.size(); h++) {
+		for(int s : succs[order[h]]) {
+			if(--indeg[s] == 0) order.push_back(s);
+		}
+	}
+
+	//dense ids for load and store groups
+	map<pair<bool, int>, int> grpIds;
+	memGroup.assign(numVertices, -1);
+	for(list<Node>::iterator it = gp.nodeBegin(); it != gp.nodeEnd(); it++) {
+		string op = it->getLabel();
+		bool ld = isLoadOp(op);
+		if(!ld && !isStoreOp(op)) continue;
+		pair<bool, int> key = {!ld, getMemGroup(op)};
+		if(grpIds.find(key) == grpIds.end()) {
+			grpIds[key] = grpStore.size();
+			grpStore.push_back(!ld);
+		}
+		memGroup[it->getID()] = grpIds[key];
+	}
+	numGroups = grpStore.size();
+	weight.assign(numVertices, 1);
+
+	ReachIndex reach(gp);
+	nAnc.resize(numVertices);
+	nDesc.resize(numVertices);
+	for(int v = 0; v < numVertices; v++) {
+		nAnc[v] = reach.numAncestors(v);
+		nDesc[v] = reach.numDescendants(v);
+	}
+
+	if(lim.fu.limited()) {
+		numClasses = lim.fu.numClasses();
+		classUse = lim.fu.usage(gp);
+		for(int c = 0; c < numClasses; c++) {
+			classCap.push_back(lim.fu.getCapacity(c));
+		}
+	}
+}
+
+void PartBnB::initState(BnBState &s) {
+	s.part.assign(numVertices, -1);
+	s.size.assign(numParts, 0);
+	s.reads.assign(numParts, 0);
+	s.writes.assign(numParts, 0);
+	s.loads.assign(numParts, 0);
+	s.stores.assign(numParts, 0);
+	s.useCnt.assign((size_t)numVertices * numParts, 0);
+	s.useMask.assign(numVertices, numParts);
+	s.laterCnt.assign(numVertices, 0);
+	s.grpCnt.assign((size_t)numGroups * numParts, 0);
+	s.grpAssigned.assign(numGroups, 0);
+	s.classCnt.assign((size_t)numParts * numClasses, 0);
+	s.lastUse.assign(numVertices, -1);
+	s.resident.assign(numParts, 0);
+	s.unstarted = numGroups;
+	s.maxUsed = -1;
+	s.cost = 0;
+	s.nodes = 0;
+	s.budget = LONG_MAX;
+	s.lb.assign(numVertices, 0);
+	s.bucket.assign(numParts, 0);
+	s.freeGe.assign(numParts + 1, 0);
+	s.mark.assign(numVertices, 0);
+	s.markStamp = 0;
+}
+
+void PartBnB::apply(BnBState &s, int v, int p) {
+	s.part[v] = p;
+	s.size[p] += weight[v];
+	for(int c = 0; c < numClasses; c++) {
+		s.classCnt[p * numClasses + c] += classUse[v * numClasses + c];
+	}
+	for(int u : preds[v]) {
+		int k = s.part[u];
+		if(k < p && s.useCnt[u * numParts + p]++ == 0) { //first use of value u in p
+			s.useMask.set(u, p);
+			s.reads[p]++;
+			s.cost += 2 * writeWeight;
+			if(s.laterCnt[u]++ == 0) s.writes[k]++; //first time u leaves its partition
+			if(SPSize < INT_MAX && p > s.lastUse[u]) { //u now stays in the scratchpad up to p
+				for(int l = max(s.lastUse[u], k) + 1; l <= p; l++) s.resident[l]++;
+				s.lastUse[u] = p;
+			}
+		}
+	}
+	int g = memGroup[v];
+	if(g >= 0) {
+		if(s.grpAssigned[g]++ == 0) s.unstarted--;
+		if(s.grpCnt[g * numParts + p]++ == 0) {
+			if(grpStore[g]) s.stores[p]++;
+			else s.loads[p]++;
+			s.cost += loadWeight;
+		}
+	}
+}
+
+//exact reverse of apply
+void PartBnB::undo(BnBState &s, int v) {
+	int p = s.part[v];
+	int g = memGroup[v];
+	if(g >= 0) {
+		if(--s.grpCnt[g * numParts + p] == 0) {
+			if(grpStore[g]) s.stores[p]--;
+			else s.loads[p]--;
+			s.cost -= loadWeight;
+		}
+		if(--s.grpAssigned[g] == 0) s.unstarted++;
+	}
+	for(int u : preds[v]) {
+		int k = s.part[u];
+		if(k < p && --s.useCnt[u * numParts + p] == 0) {
+			s.useMask.reset(u, p);
+			s.reads[p]--;
+			s.cost -= 2 * writeWeight;
+			if(--s.laterCnt[u] == 0) s.writes[k]--;
+			if(SPSize < INT_MAX && s.lastUse[u] == p) {
+				int l = p - 1;
+				while(l > k && !s.useMask.test(u, l)) l--;
+				for(int q = l + 1; q <= p; q++) s.resident[q]--;
+				s.lastUse[u] = l > k ? l : -1;
+			}
+		}
+	}
+	for(int c = 0; c < numClasses; c++) {
+		s.classCnt[p * numClasses + c] -= classUse[v * numClasses + c];
+	}
+	s.size[p] -= weight[v];
+	s.part[v] = -1;
+}
+
+//limits of the partitions the last apply of v touched
+bool PartBnB::feasibleAfter(BnBState &s, int v) {
+	int p = s.part[v];
+	if(s.size[p] > RSize) return false;
+	for(int c = 0; c < numClasses; c++) {
+		if(s.classCnt[p * numClasses + c] > classCap[c]) return false;
+	}
+	if(!hoistLoads && s.reads[p] + s.loads[p] > TSize) return false;
+	if(hoistLoads) {
+		if(s.reads[p] + (p + 1 < numParts ? s.loads[p + 1] : 0) > TSize) return false;
+		if((p > 0 ? s.reads[p - 1] : 0) + s.loads[p] > TSize) return false; //prefetched during p - 1
+	}
+	if(s.writes[p] + s.stores[p] > TSize) return false;
+	for(int u : preds[v]) {
+		int k = s.part[u];
+		if(s.writes[k] + s.stores[k] > TSize) return false;
+		for(int l = k + 1; SPSize < INT_MAX && l <= p; l++) {
+			if(s.resident[l] > SPSize) return false;
+		}
+	}
+	return true;
+}
+
+//lower bound on the cost of any completion of the first d vertices of order, LONG_MAX if
+//the remaining vertices cannot fit
+long PartBnB::bound(BnBState &s, int d) {
+	//earliest partition of every unassigned vertex
+	fill(s.bucket.begin(), s.bucket.end(), 0);
+	for(int idx = d; idx < numVertices; idx++) {
+		int v = order[idx];
+		int l = winLo(v);
+		for(int u : preds[v]) {
+			l = max(l, s.part[u] >= 0 ? s.part[u] : s.lb[u]);
+		}
+		if(l > winHi(v)) return LONG_MAX;
+		s.lb[v] = l;
+		s.bucket[l] += weight[v];
+	}
+
+	//remaining capacity: vertices that cannot go before t must fit in partitions t..P-1
+	s.freeGe[numParts] = 0;
+	int need = 0;
+	for(int t = numParts - 1; t >= 0; t--) {
+		s.freeGe[t] = s.freeGe[t + 1] + RSize - s.size[t];
+		need += s.bucket[t];
+		if(need > s.freeGe[t]) return LONG_MAX;
+	}
+
+	//every load/store group still untouched costs at least one transaction
+	long lbCost = s.cost + (long)loadWeight * s.unstarted;
+
+	//unavoidable cut edges: an assigned value consumed by an unassigned vertex that cannot share
+	//its partition and is not read yet in any partition the consumer may go to costs another read
+	s.markStamp++;
+	for(int idx = d; idx < numVertices; idx++) {
+		int v = order[idx];
+		for(int u : preds[v]) {
+			int k = s.part[u];
+			if(k < 0 || k >= s.lb[v] || s.mark[u] == s.markStamp) continue;
+			int q = nextBit(s.useMask.row(u), s.useMask.rowWords(), s.lb[v]);
+			if(q < 0 || q > s.maxUsed) {
+				s.mark[u] = s.markStamp;
+				lbCost += 2 * writeWeight;
+			}
+		}
+	}
+	return lbCost;
+}
+
+//feasible partitions for the vertex at depth d with the cost they lead to, cheapest first;
+//a vertex opens at most one new partition so empty partitions never sit between used ones
+void PartBnB::candidates(BnBState &s, int d, vector<pair<long, int>> &cand) {
+	cand.clear();
+	int v = order[d];
+	int lo = winLo(v);
+	for(int u : preds[v]) lo = max(lo, s.part[u]);
+	int hi = min(winHi(v), s.maxUsed + 1);
+	for(int p = lo; p <= hi; p++) {
+		apply(s, v, p);
+		if(feasibleAfter(s, v)) cand.push_back({s.cost, p});
+		undo(s, v);
+	}
+	stable_sort(cand.begin(), cand.end());
+}
+
+void PartBnB::offer(BnBState &s) {
+	lock_guard<mutex> lk(bestMtx);
+	if(s.cost < bestCost) {
+		bestCost = s.cost;
+		bestPart = s.part;
+	}
+}
+
+void PartBnB::dfs(BnBState &s, int d) {
+	if(stopped || s.nodes >= s.budget) return;
+	if((++s.nodes & 4095) == 0) {
+		totalNodes += 4096;
+		if((timeLimit > 0 && chrono::steady_clock::now() > deadline) || (nodeLimit > 0 && totalNodes >= nodeLimit)) {
+			stopped = true;
+			return;
+		}
+	}
+	if(d == numVertices) {
+		offer(s);
+		return;
+	}
+	if(bound(s, d) >= bestCost) return;
+
+	vector<pair<long, int>> cand;
+	candidates(s, d, cand);
+	int v = order[d];
+	int oldMax = s.maxUsed;
+	for(auto &c : cand) {
+		if(c.first >= bestCost) break; //costs only grow further down
+		apply(s, v, c.second);
+		s.maxUsed = max(oldMax, c.second);
+		dfs(s, d + 1);
+		undo(s, v);
+		s.maxUsed = oldMax;
+	}
+}
+
+//incumbent: the cheapest first depth first search on one thread, cut off after a few thousand nodes
+void PartBnB::dive(BnBState &s) {
+	s.budget = 20000;
+	dfs(s, 0);
+	totalNodes += s.nodes & 4095;
+}
+
+bool PartBnB::solve(int nParts, vector<int> &part) {
+	numParts = nParts;
+	bestCost = LONG_MAX;
+	bestPart.clear();
+	stopped = false;
+	totalNodes = 0;
+	deadline = chrono::steady_clock::now() + chrono::milliseconds((long)(timeLimit * 1000));
+
+	{
+		BnBState s;
+		initState(s);
+		dive(s);
+	}
+	cout << "Initial incumbent " << (bestPart.empty() ? string("none") : to_string(bestCost)) << endl;
+
+	ThreadPool pool(nThreads);
+
+	//split the tree breadth first until every thread has several subtrees to work on
+	vector<vector<int>> frontier(1); //partition choices along order
+	int depth = 0;
+	vector<pair<long, int>> cand;
+	while(depth < numVertices && frontier.size() < 8 * (size_t)pool.size() && !frontier.empty()) {
+		vector<vector<int>> next;
+		for(auto &prefix : frontier) {
+			BnBState s;
+			initState(s);
+			for(int d = 0; d < depth; d++) {
+				apply(s, order[d], prefix[d]);
+				s.maxUsed = max(s.maxUsed, prefix[d]);
+			}
+			if(bound(s, depth) >= bestCost) continue;
+			candidates(s, depth, cand);
+			for(auto &c : cand) {
+				next.push_back(prefix);
+				next.back().push_back(c.second);
+			}
+		}
+		frontier.swap(next);
+		depth++;
+	}
+
+	for(auto &prefix : frontier) {
+		pool.submit([this, &prefix, depth] {
+			BnBState s;
+			initState(s);
+			for(int d = 0; d < depth; d++) {
+				apply(s, order[d], prefix[d]);
+				s.maxUsed = max(s.maxUsed, prefix[d]);
+			}
+			dfs(s, depth);
+			totalNodes += s.nodes & 4095;
+		});
+	}
+	pool.wait();
+
+	cout << "Branch and bound with partitions " << numParts << " nodes " << totalNodes << (stopped ? " stopped at time limit" : " complete") << endl;
+	part = bestPart;
+	return !bestPart.empty();
+}
@@ -0,0 +1,141 @@
+#include "PartCache.h"
+#include "PartResult.h"
+#include "PartEval.h"
+#include "DFGUtils.h"
+#include <sys/stat.h>
+#include <unistd.h>
+
+static uint64_t mix64(uint64_t h, uint64_t x) {
+	h ^= x + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+	h ^= h >> 31;
+	h *= 0xbf58476d1ce4e5b9ULL;
+	h ^= h >> 29;
+	return h;
+}
+
+//fold the sorted colours of a neighbour list into h
+static uint64_t mixSorted(uint64_t h, const vector<int> &nbrs, const vector<uint64_t> &color, vector<uint64_t> &buf) {
+	buf.clear();
+	for(int u : nbrs) buf.push_back(color[u]);
+	sort(buf.begin(), buf.end());
+	h = mix64(h, buf.size());
+	for(uint64_t c : buf) h = mix64(h, c);
+	return h;
+}
+
+uint64_t canonicalHash(DAG &gp, vector<int> &canon) {
+	int n = gp.getNumNodes();
+	vector<vector<int>> succs(n), preds(n), mates(n);
+	for(list<Edge>::iterator it = gp.edgeBegin(); it != gp.edgeEnd(); it++) {
+		succs[it->getSrcNodeID()].push_back(it->getDestNodeID());
+		preds[it->getDestNodeID()].push_back(it->getSrcNodeID());
+	}
+
+	//initial colour is the operation without its group id; group ids are just names, so group
+	//membership enters the refinement as a neighbour relation
+	vector<uint64_t> color(n);
+	map<pair<bool, int>, vector<int>> groups;
+	for(list<Node>::iterator it = gp.nodeBegin(); it != gp.nodeEnd(); it++) {
+		string op = it->getLabel();
+		int v = it->getID();
+		bool ld = isLoadOp(op);
+		if((ld || isStoreOp(op)) && op.find(";") != string::npos) {
+			groups[{!ld, getMemGroup(op)}].push_back(v);
+			op = op.substr(0, op.find(";"));
+		}
+		color[v] = hashString(op);
+	}
+	for(auto &grp : groups) {
+		for(int v : grp.second) mates[v] = grp.second;
+	}
+
+	//refine until the number of colour classes stops growing
+	vector<uint64_t> next(n), buf;
+	int classes = 0;
+	for(int round = 0; round < n; round++) {
+		for(int v = 0; v < n; v++) {
+			uint64_t h = mix64(color[v], 1);
+			h = mixSorted(h, preds[v], color, buf);
+			h = mixSorted(h, succs[v], color, buf);
+			h = mixSorted(h, mates[v], color, buf);
+			next[v] = h;
+		}
+		color.swap(next);
+		buf = color;
+		sort(buf.begin(), buf.end());
+		int nc = unique(buf.begin(), buf.end()) - buf.begin();
+		if(nc == classes) break;
+		classes = nc;
+	}
+
+	canon.resize(n);
+	iota(canon.begin(), canon.end(), 0);
+	stable_sort(canon.begin(), canon.end(), [&](int a, int b) {return color[a] < color[b];});
+
+	uint64_t h = mix64(n, gp.getNumEdges());
+	for(int v : canon) h = mix64(h, color[v]);
+	return h;
+}
+
+PartCache::PartCache(const string &cacheDir) {
+	dir = cacheDir;
+	if(dir.empty()) {
+		const char *env = getenv("DFG_PART_CACHE");
+		dir = env != NULL ? env : ".partcache";
+	}
+	mkdir(dir.c_str(), 0777);
+}
+
+string PartCache::entryName(uint64_t hash, const string &solver, const partLimits &lim) {
+	char hex[17];
+	snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)hash);
+	return dir + "/" + hex + "_" + solver + "_" + to_string(lim.RSize) + "_" + to_string(lim.TSize) + "_" + to_string(lim.loadWeight) + ".part";
+}
+
+bool PartCache::lookup(DAG &gp, const string &solver, const partLimits &lim, vector<int> &part, int &numParts) {
+	vector<int> canon;
+	uint64_t hash = canonicalHash(gp, canon);
+	PartResult res;
+	if(readPartResult(entryName(hash, solver, lim), res) != "") return false;
+	if(res.graphHash != hash || res.numVertices != (int)canon.size()) return false;
+
+	vector<int> cand(canon.size());
+	for(size_t r = 0; r < canon.size(); r++) {
+		cand[canon[r]] = res.part[r];
+	}
+	try {
+		PartEval eval(gp, lim);
+		vector<partCounts> counts;
+		if(eval.validate(cand, res.numParts, counts) != "") return false;
+		if(res.cost >= 0 && eval.cost(counts) != res.cost) return false; //same hash, different graph
+	} catch(exception &ex) { //load/store labels without a group
+		return false;
+	}
+
+	cout << "Cache hit " << entryName(hash, solver, lim) << endl;
+	part = cand;
+	numParts = res.numParts;
+	return true;
+}
+
+void PartCache::store(DAG &gp, const string &solver, const partLimits &lim, const vector<int> &part, int numParts) {
+	vector<int> canon;
+	uint64_t hash = canonicalHash(gp, canon);
+	PartResult res;
+	try {
+		res = makeResult(gp, part, numParts, lim);
+	} catch(exception &ex) { //load/store labels without a group
+		return;
+	}
+	res.graphHash = hash;
+	for(size_t r = 0; r < canon.size(); r++) {
+		res.part[r] = part[canon[r]];
+	}
+
+	//write under a temporary name and rename so concurrent runs never read half an entry
+	string fname = entryName(hash, solver, lim);
+	string tmp = fname + "." + to_string(getpid());
+	if(writePartResult(tmp, res) == "") {
+		rename(tmp.c_str(), fname.c_str());
+	}
+}
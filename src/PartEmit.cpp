@@ -0,0 +1,159 @@
+#include "PartEmit.h"
+#include "ThreadPool.h"
+#include <sys/stat.h>
+
+//kinds of edge entries in a partition bucket
+#define EDGE_IN 0 //both ends in the partition
+#define EDGE_WRITE 1 //source in the partition, destination in a later one
+#define EDGE_READ 2 //destination in the partition, source in an earlier one
+
+PartEmitter::PartEmitter(DAG &gp) {
+	labels.resize(gp.getNumNodes());
+	for(list<Node>::iterator it = gp.nodeBegin(); it != gp.nodeEnd(); it++) {
+		labels[it->getID()] = it->getLabel();
+	}
+	for(list<Edge>::iterator it = gp.edgeBegin(); it != gp.edgeEnd(); it++) {
+		edgeSrc.push_back(it->getSrcNodeID());
+		edgeDst.push_back(it->getDestNodeID());
+		edgeLabel.push_back(it->getLabel());
+	}
+}
+
+//the text toDOT writes, built straight from the edge arrays: no DAG to fill one node at a time
+//and no library call shared between the emitting threads
+void PartEmitter::writeDOT(const string &fname, const vector<int> &verts, const vector<pair<int, char>> &edges, const vector<int> &local) {
+	string out = "digraph  {\n";
+	int norm = 0;
+	for(int v : verts) {
+		out += "   " + to_string(norm++) + " [label=\"" + labels[v] + "\"];\n";
+	}
+	for(auto &en : edges) {
+		if(en.second == EDGE_WRITE) out += "   " + to_string(norm++) + " [label=\"sc_pad_write\"];\n";
+		else if(en.second == EDGE_READ) out += "   " + to_string(norm++) + " [label=\"sc_pad_read\"];\n";
+	}
+	out += "\n";
+	norm = verts.size();
+	for(auto &en : edges) {
+		int e = en.first;
+		int src = en.second == EDGE_READ ? norm++ : local[edgeSrc[e]];
+		int dst = en.second == EDGE_WRITE ? norm++ : local[edgeDst[e]];
+		out += "   " + to_string(src) + "->" + to_string(dst) + " [label=\"" + edgeLabel[e] + "\"]\n";
+	}
+	out += "}\n";
+
+	FILE *fp = fopen(fname.c_str(), "w");
+	if(fp == NULL) {
+		cout << "Cannot open " << fname << endl;
+		return;
+	}
+	fwrite(out.data(), 1, out.size(), fp);
+	fclose(fp);
+}
+
+static void putU32(vector<char> &buf, uint32_t x) {
+	for(int b = 0; b < 4; b++) buf.push_back((char)((x >> (8 * b)) & 0xff));
+}
+
+static void putStr(vector<char> &buf, const string &s) {
+	putU32(buf, s.size());
+	buf.insert(buf.end(), s.begin(), s.end());
+}
+
+void PartEmitter::writeBinary(const string &fname, const vector<int> &verts, const vector<pair<int, char>> &edges, const vector<int> &local) {
+	int nPads = 0;
+	for(auto &en : edges) nPads += en.second != EDGE_IN;
+
+	vector<char> buf;
+	buf.insert(buf.end(), {'D', 'F', 'G', 'P'});
+	putU32(buf, 1); //version
+	putU32(buf, verts.size() + nPads);
+	putU32(buf, edges.size());
+	for(int v : verts) {
+		putStr(buf, labels[v]);
+	}
+	for(auto &en : edges) {
+		if(en.second == EDGE_WRITE) putStr(buf, "sc_pad_write");
+		else if(en.second == EDGE_READ) putStr(buf, "sc_pad_read");
+	}
+	int norm = verts.size();
+	for(auto &en : edges) {
+		int e = en.first;
+		if(en.second == EDGE_IN) {
+			putU32(buf, local[edgeSrc[e]]);
+			putU32(buf, local[edgeDst[e]]);
+		}
+		else if(en.second == EDGE_WRITE) {
+			putU32(buf, local[edgeSrc[e]]);
+			putU32(buf, norm++);
+		}
+		else {
+			putU32(buf, norm++);
+			putU32(buf, local[edgeDst[e]]);
+		}
+		putStr(buf, edgeLabel[e]);
+	}
+
+	FILE *fp = fopen(fname.c_str(), "wb");
+	if(fp == NULL) {
+		cout << "Cannot open " << fname << endl;
+		return;
+	}
+	fwrite(buf.data(), 1, buf.size(), fp);
+	fclose(fp);
+}
+
+int PartEmitter::emit(const vector<int> &part, int numParts, const string &dir, bool binary, int nThreads) {
+	int numVertices = labels.size();
+	if((int)part.size() != numVertices) {
+		cout << "Assignment has " << part.size() << " vertices, graph has " << numVertices << endl;
+		return 0;
+	}
+
+	//vertices of each partition in id order and their ids inside it
+	vector<vector<int>> verts(numParts);
+	vector<int> local(numVertices);
+	for(int v = 0; v < numVertices; v++) {
+		local[v] = verts[part[v]].size();
+		verts[part[v]].push_back(v);
+	}
+
+	//one pass over the edges, a cut edge lands in the buckets of both of its partitions
+	vector<vector<pair<int, char>>> edges(numParts);
+	for(int e = 0; e < (int)edgeSrc.size(); e++) {
+		int k = part[edgeSrc[e]], l = part[edgeDst[e]];
+		if(k == l) {
+			edges[k].push_back({e, EDGE_IN});
+		}
+		else if(k < l) {
+			edges[k].push_back({e, EDGE_WRITE});
+			edges[l].push_back({e, EDGE_READ});
+		}
+	}
+
+	//make outputParts/ and the directory of this run, existing ones are fine
+	for(size_t pos = dir.find('/'); pos != string::npos; pos = dir.find('/', pos + 1)) {
+		mkdir(dir.substr(0, pos).c_str(), 0777);
+	}
+	mkdir(dir.c_str(), 0777);
+	cout << "Writing " << numParts << " partitions to " << dir << endl;
+
+	ThreadPool pool(min(nThreads < 1 ? (int)thread::hardware_concurrency() : nThreads, max(numParts, 1)));
+	for(int p = 0; p < numParts; p++) {
+		pool.submit([&, p] {
+			string fname = dir + (dir.empty() || dir.back() == '/' ? "" : "/") + to_string(p) + (binary ? ".bin" : ".dot");
+			if(binary) writeBinary(fname, verts[p], edges[p], local);
+			else writeDOT(fname, verts[p], edges[p], local);
+		});
+	}
+	pool.wait();
+	return numParts;
+}
+
+string partsDir(const string &graphName, int RSize, int TSize, int loadWeight) {
+	string name = graphName.substr(graphName.rfind("/") + 1); //get last part of the name
+	if(name.size() > 4 && name.substr(name.size() - 4) == ".dot") {
+		name.erase(name.size() - 4, 4); //erase the last ".dot"
+	}
+	//add param of size, trans limit, ldweight to directory name
+	return "outputParts/" + name + "_" + to_string(RSize) + "_" + to_string(TSize) + "_" + to_string(loadWeight) + "/";
+}
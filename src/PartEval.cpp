@@ -0,0 +1,138 @@
+#include "PartEval.h"
+#include "DFGUtils.h"
+
+PartEval::PartEval(DAG &gp, const partLimits &limits) : lim(limits) {
+	numVertices = gp.getNumNodes();
+
+	vector<vector<int>> succs(numVertices);
+	for(list<Edge>::iterator it = gp.edgeBegin(); it != gp.edgeEnd(); it++) {
+		edgeSrc.push_back(it->getSrcNodeID());
+		edgeDst.push_back(it->getDestNodeID());
+		succs[it->getSrcNodeID()].push_back(it->getDestNodeID());
+	}
+	succBeg.push_back(0);
+	for(auto &sv : succs) {
+		sort(sv.begin(), sv.end());
+		sv.erase(unique(sv.begin(), sv.end()), sv.end()); //one value per vertex
+		succList.insert(succList.end(), sv.begin(), sv.end());
+		succBeg.push_back(succList.size());
+	}
+
+	//dense ids for load and store groups
+	map<pair<bool, int>, int> grpIds;
+	memGroup.assign(numVertices, -1);
+	for(list<Node>::iterator it = gp.nodeBegin(); it != gp.nodeEnd(); it++) {
+		string op = it->getLabel();
+		bool ld = isLoadOp(op);
+		if(!ld && !isStoreOp(op)) continue;
+		pair<bool, int> key = {!ld, getMemGroup(op)};
+		if(grpIds.find(key) == grpIds.end()) {
+			grpIds[key] = grpStore.size();
+			grpStore.push_back(!ld);
+		}
+		memGroup[it->getID()] = grpIds[key];
+	}
+	loadMask.assign(bitWords(grpStore.size()), 0);
+	storeMask.assign(bitWords(grpStore.size()), 0);
+	for(int g = 0; g < (int)grpStore.size(); g++) {
+		setBit(grpStore[g] ? storeMask.data() : loadMask.data(), g);
+	}
+	if(lim.fu.limited()) {
+		fuUse = lim.fu.usage(gp);
+	}
+}
+
+string PartEval::validate(const vector<int> &part, int numParts, vector<partCounts> &counts) {
+	counts.assign(numParts, partCounts{0, 0, 0, 0, 0, 0, 0, 0});
+	if((int)part.size() != numVertices) return "assignment has " + to_string(part.size()) + " vertices, graph has " + to_string(numVertices);
+
+	//uniqueness and size
+	for(int v = 0; v < numVertices; v++) {
+		if(part[v] < 0 || part[v] >= numParts) return "vertex " + to_string(v) + " is not mapped to a partition";
+		counts[part[v]].size++;
+	}
+
+	//precedence and edge counts
+	for(size_t e = 0; e < edgeSrc.size(); e++) {
+		int k = part[edgeSrc[e]], l = part[edgeDst[e]];
+		if(k > l) return "edge " + to_string(edgeSrc[e]) + "->" + to_string(edgeDst[e]) + " goes from partition " + to_string(k) + " back to " + to_string(l);
+		if(k < l) {
+			counts[k].outEdges++;
+			counts[l].inEdges++;
+		}
+	}
+
+	//one write per value leaving its partition, one read per distinct later partition using it,
+	//resident in the scratchpad from the next partition up to the last of them
+	vector<int> resStart(numParts + 1, 0);
+	succParts.assign(numVertices, numParts);
+	size_t W = succParts.rowWords();
+	for(int v = 0; v < numVertices; v++) {
+		uint64_t *row = succParts.row(v);
+		for(int s = succBeg[v]; s < succBeg[v + 1]; s++) {
+			setBit(row, part[succList[s]]);
+		}
+		int k = part[v];
+		int l = nextBit(row, W, k + 1);
+		if(l >= 0) {
+			counts[k].writes++;
+			resStart[k + 1]++;
+		}
+		int last = -1;
+		for(; l >= 0; l = nextBit(row, W, l + 1)) {
+			counts[l].reads++;
+			last = l;
+		}
+		if(last >= 0) resStart[last + 1]--;
+	}
+	for(int p = 0, live = 0; p < numParts; p++) {
+		live += resStart[p];
+		counts[p].resident = live;
+	}
+
+	//one transaction per group present in a partition
+	int numGroups = grpStore.size();
+	partGroups.assign(numParts, numGroups);
+	for(int v = 0; v < numVertices; v++) {
+		if(memGroup[v] >= 0) partGroups.set(part[v], memGroup[v]);
+	}
+	for(int p = 0; p < numParts; p++) {
+		counts[p].loads = popcountAnd(partGroups.row(p), loadMask.data(), partGroups.rowWords());
+		counts[p].stores = popcountAnd(partGroups.row(p), storeMask.data(), partGroups.rowWords());
+	}
+
+	if(lim.pipelined && numParts > 0 && counts[0].loads > lim.TSize) return "partition 0 prefetches " + to_string(counts[0].loads) + " load transactions, limit is " + to_string(lim.TSize);
+	for(int p = 0; p < numParts; p++) {
+		int readTrans = counts[p].reads + (!lim.pipelined ? counts[p].loads : p + 1 < numParts ? counts[p + 1].loads : 0);
+		if(counts[p].size > lim.RSize) return "partition " + to_string(p) + " holds " + to_string(counts[p].size) + " vertices, capacity is " + to_string(lim.RSize);
+		if(readTrans > lim.TSize) return "partition " + to_string(p) + " needs " + to_string(readTrans) + " read transactions, limit is " + to_string(lim.TSize);
+		if(counts[p].writes + counts[p].stores > lim.TSize) return "partition " + to_string(p) + " needs " + to_string(counts[p].writes + counts[p].stores) + " write transactions, limit is " + to_string(lim.TSize);
+		if(counts[p].resident > lim.spSize) return "partition " + to_string(p) + " keeps " + to_string(counts[p].resident) + " values in the scratchpad, capacity is " + to_string(lim.spSize);
+	}
+	return fuUse.empty() ? "" : lim.fu.check(fuUse, part, numParts);
+}
+
+long PartEval::cost(const vector<partCounts> &counts) const {
+	long mem = 0, reads = 0;
+	for(auto &pc : counts) {
+		mem += pc.loads + pc.stores;
+		reads += pc.reads;
+	}
+	return lim.loadWeight * mem + 2 * writeWeight * reads;
+}
+
+void PartEval::printCounts(const vector<partCounts> &counts) const {
+	int loadTrans = 0, storeTrans = 0;
+	for(auto &pc : counts) {
+		loadTrans += pc.loads;
+		storeTrans += pc.stores;
+	}
+	cout << "Load transactions = " << loadTrans << endl;
+	cout << "Store transactions = " << storeTrans << endl;
+	cout << "Total transactions = " << storeTrans + loadTrans << " Total cost " << lim.loadWeight * (storeTrans + loadTrans) << endl;
+	cout << "Write counts Out Edges Reads In Edges per partition ";
+	for(auto &pc : counts) {
+		cout << pc.writes << " " << pc.outEdges << " " << pc.reads << " " << pc.inEdges << " ";
+	}
+	cout << endl;
+}
@@ -0,0 +1,585 @@
+#include "PartModel.h"
+#include "DFGUtils.h"
+#include "ReachIndex.h"
+
+PartModel::PartModel(DAG gp, int nPts, const partLimits &lim) : lp("partition"), fu(lim.fu) {
+	graph = gp;
+	RSize = lim.RSize; //partition size
+	TSize = lim.TSize; //transaction limit size
+	loadWeight = lim.loadWeight; //weight of load
+	SPSize = lim.spSize; //scratchpad slots
+	hoistLoads = lim.pipelined; //loads prefetched a partition early
+	numVertices = gp.getNumNodes();
+	numEdges = gp.getNumEdges();
+	numParts = nPts;
+	nPairs = numParts * (numParts - 1) / 2;
+
+	//unique successors of each vertex, parallel edges carry the same value
+	succs.resize(numVertices);
+	for(list<Edge>::iterator it = graph.edgeBegin(); it != graph.edgeEnd(); it++) {
+		succs[it->getSrcNodeID()].push_back(it->getDestNodeID());
+	}
+	for(auto &sv : succs) {
+		sort(sv.begin(), sv.end());
+		sv.erase(unique(sv.begin(), sv.end()), sv.end());
+	}
+	if(fu.limited()) {
+		classUse = fu.usage(graph);
+	}
+}
+
+void PartModel::setBoundary(const vector<vector<int>> &bReads, const vector<int> &bWrites, int prevReads) {
+	bndReads = bReads;
+	bndWrites = bWrites;
+	bndPrefetch = prevReads;
+}
+
+void PartModel::addColVars() {
+	//add all vertices-parts mapping as cols
+	lp.clear();
+	int count = 0;
+	xBase = lp.getNumCols();
+	for(int i = 0; i < numVertices; i++) {
+		for(int j = 0; j < numParts; j++) {
+			lp.addBinCol("x" + to_string(i) + "," + to_string(j)); //Xij's have no cost
+			count++;
+		}
+	}
+	cout << "Xij variable added count = " << count << endl;
+	this->nXij = count; //append count
+
+	if(prune) {
+		//i and its ancestors fill partitions 0..j, i and its descendants partitions j..numParts-1
+		ReachIndex reach(graph);
+		int fixed = 0;
+		for(int i = 0; i < numVertices; i++) {
+			int lo = (reach.numAncestors(i) + getWeight(i) + RSize - 1) / RSize - 1;
+			int hi = numParts - (reach.numDescendants(i) + getWeight(i) + RSize - 1) / RSize;
+			for(int j = 0; j < numParts; j++) {
+				if(j < lo || j > hi) {
+					lp.fixCol(xij(i, j), 0);
+					fixed++;
+				}
+			}
+		}
+		cout << "Xij fixed to 0 by reachability " << fixed << endl;
+	}
+
+	//iterate through graph nodes and store load ids in corresponding group vector
+	for(list<Node>::iterator it = graph.nodeBegin(); it != graph.nodeEnd(); it++) {
+		string op = it->getLabel();
+		if(isLoadOp(op)) {
+			loadGroups[getMemGroup(op)].push_back(it->getID());
+			this->numLoads++;//inc number of loads
+		} else if(isStoreOp(op)) {
+			storeGroups[getMemGroup(op)].push_back(it->getID());
+			this->numStores++; //inc number of stores
+		}
+
+		//if successors present increment vout
+		if(succs[it->getID()].size() > 0) {
+			this->Vout++;
+		}
+	}
+
+	count = 0;
+	//add partition number of load boolean variable..each represent if there is atleast one load of the group in given partition
+	for(auto elem : loadGroups) {
+		vector<int> lpV;
+		for(int i = 0; i < numParts; i++) {
+			string name = "lpg" + to_string(elem.first) + "," + to_string(i);
+			lpV.push_back(lp.addBinCol(name, loadWeight)); //objective function's coefficient is loadweight
+			count++; //increment count of load group variables
+		}
+		lpgMap[elem.first] = lpV;
+	}
+	this->nLp = count; //assign count to load group variables
+
+	count = 0;
+	//same for stores
+	for(auto elem : storeGroups) {
+		vector<int> lpV;
+		for(int i = 0; i < numParts; i++) {
+			string name = "lps" + to_string(elem.first) + "," + to_string(i);
+			lpV.push_back(lp.addBinCol(name, loadWeight));
+			count++; //increment count of store group variables
+		}
+		lpsMap[elem.first] = lpV;
+	}
+	this->nLp += count; //assign count to store group variables
+
+	count = 0;
+	//define kl variables for each i for inter communication..define for both y and x variables
+	//a set Xikl is counted once for the write from k and once for the read in l
+	inBase = lp.getNumCols();
+	for(int i = 0; i < numVertices; i++) {
+		for(int k = 0; k < numParts - 1; k++) {
+			for(int l = k + 1; l < numParts; l++) {
+				count += 2; //increment twice
+				string kl = to_string(i) + "_" + to_string(k) + "_" + to_string(l);
+				lp.addBinCol("x_" + kl, 2 * writeWeight);
+				lp.addBinCol("y_" + kl, 0);
+			}
+		}
+	}
+
+	//boundary values are written before the model, each partition using one costs a read
+	rBase = lp.getNumCols();
+	for(int b = 0; b < (int)bndReads.size(); b++) {
+		for(int l = 0; l < numParts; l++) {
+			lp.addBinCol("r_" + to_string(b) + "_" + to_string(l), 2 * writeWeight);
+			count++;
+		}
+	}
+	this->nInPa = count;
+}
+
+//add uniqueness constraint of mapping n vertices to p partitions
+void PartModel::addUniqueCons() {
+	int nCons = 0;
+	for(int i = 0; i < numVertices; i++) {
+		lp.beginRow("u" + to_string(i), 1, 1);
+		for(int j = 0; j < numParts; j++) {
+			lp.addCoef(xij(i, j), 1);
+		}
+		nCons++;
+	}
+	this->nUniqCons = nCons;
+	cout << "Number of uniquness constraints rows added " << nCons << endl;
+}
+
+void PartModel::addSizeCons() {
+	int nCons = 0;
+	for(int i = 0; i < numParts; i++) {
+		lp.beginRow("cap" + to_string(i), 0, RSize);
+		for(int j = 0; j < numVertices; j++) {
+			lp.addCoef(xij(j, i), getWeight(j));
+		}
+		nCons++;
+	}
+	//a row per partition for every class whose vertices would not all fit in one
+	int nc = fu.numClasses();
+	for(int c = 0; c < nc && !classUse.empty(); c++) {
+		long total = 0;
+		for(int j = 0; j < numVertices; j++) {
+			total += classUse[j * nc + c];
+		}
+		if(total <= fu.getCapacity(c)) continue;
+		for(int i = 0; i < numParts; i++) {
+			lp.beginRow("cap" + fu.getName(c) + to_string(i), 0, fu.getCapacity(c));
+			for(int j = 0; j < numVertices; j++) {
+				if(classUse[j * nc + c] > 0) lp.addCoef(xij(j, i), classUse[j * nc + c]);
+			}
+			nCons++;
+		}
+	}
+	this->nCapCons = nCons;
+	cout << "Number of size constraint rows " << nCons << endl;
+}
+
+void PartModel::addEdgePrec() {
+	int nCons = 0;
+	for(list<Edge>::iterator it = graph.edgeBegin(); it != graph.edgeEnd(); it++) {
+		uint32_t src_i = it->getSrcNodeID();
+		uint32_t dest_j = it->getDestNodeID();
+		lp.beginRow("pr" + to_string(nCons), -LP_INF, 0);
+
+		//sum of sources
+		for(int i = 0; i < numParts; i++) {
+			lp.addCoef(xij(src_i, i), i);
+		}
+
+		//sum of dests
+		for(int j = 0; j < numParts; j++) {
+			lp.addCoef(xij(dest_j, j), -j);
+		}
+		nCons++;
+	}
+	nPrecCons = nCons;
+	cout << "Number of edge precedence constraints " << nCons << endl;
+}
+
+//Xikl and Yikl rows of one vertex and partition pair, added on demand in lazy mode
+void PartModel::addPairRows(int i, int k, int l) {
+	const vector<int> &succ = succs[i];
+	//sum Xjl (where j is successor) >= Yikl
+	lp.beginRow("", -LP_INF, 0);
+	for(int j : succ) {
+		lp.addCoef(xij(j, l), -1);
+	}
+	lp.addCoef(yikl(i, k, l), 1);
+
+	//sum Xjl (where j is successor) <= Size of succ * Yikl
+	lp.beginRow("", -LP_INF, 0);
+	for(int j : succ) {
+		lp.addCoef(xij(j, l), 1);
+	}
+	lp.addCoef(yikl(i, k, l), -1 * (int)succ.size());
+
+	//Xik + Yikl -Xikl <= 1
+	lp.beginRow("", -LP_INF, 1);
+	lp.addCoef(xij(i, k), 1);
+	lp.addCoef(yikl(i, k, l), 1);
+	lp.addCoef(xikl(i, k, l), -1);
+
+	//-Xik - Yikl +  2.Xikl <= 0
+	lp.beginRow("", -LP_INF, 0);
+	lp.addCoef(xij(i, k), -1);
+	lp.addCoef(yikl(i, k, l), -1);
+	lp.addCoef(xikl(i, k, l), 2);
+	pairRowDone[i * nPairs + pairIdx(k, l)] = 1;
+}
+
+//add constraints for inter partition
+void PartModel::addInterPartCons() {
+	int nCons = 0;
+	pairRowDone.assign((size_t)numVertices * nPairs, 0);
+	//in lazy mode only the boundary rows below are part of the core model
+	for(list<Node>::iterator it = graph.nodeBegin(); !lazy && it != graph.nodeEnd(); it++) {
+		int i = it->getID(); //for each vertex i
+		const vector<int> &succ = succs[i];
+		string si = to_string(i);
+		if(succ.size() == 0) {
+			//set all Xikls and Yikls to 0 for this particular source node
+			for(int k = 0; k < numParts - 1; k++) {
+				for(int l = k + 1; l < numParts; l++) {
+					lp.beginRow("", 0, 0);
+					lp.addCoef(xikl(i, k, l), 1);
+					lp.beginRow("", 0, 0);
+					lp.addCoef(yikl(i, k, l), 1);
+					nCons += 2;
+				}
+			}
+			continue;
+		}
+
+		//for each partition pair kl : sum Xjl (where j is sucessor) >= Yikl
+		//for each pariition pair kl : sum Xjl (where j is successor) <= Size of succ * Yikl
+		for(int k = 0; k < numParts - 1; k++) {
+			for(int l = k + 1; l < numParts; l++) {
+				lp.beginRow("", -LP_INF, 0);
+				for(int j : succ) {
+					lp.addCoef(xij(j, l), -1);
+				}
+				lp.addCoef(yikl(i, k, l), 1);
+
+				lp.beginRow("", -LP_INF, 0);
+				for(int j : succ) {
+					lp.addCoef(xij(j, l), 1);
+				}
+				lp.addCoef(yikl(i, k, l), -1 * (int)succ.size());
+				nCons += 2;
+			}
+		}
+
+		//for each kl pair of r define the following equations
+		//Xik + Yikl <= 1 + Xikl
+		//Xik + Yikl >= 2.Xikl
+		for(int k = 0; k < numParts - 1; k++) {
+			for(int l = k + 1; l < numParts; l++) {
+				//Xik + Yikl -Xikl <= 1
+				lp.beginRow("", -LP_INF, 1);
+				lp.addCoef(xij(i, k), 1);
+				lp.addCoef(yikl(i, k, l), 1);
+				lp.addCoef(xikl(i, k, l), -1);
+
+				//-Xik - Yikl +  2.Xikl <= 0
+				lp.beginRow("", -LP_INF, 0);
+				lp.addCoef(xij(i, k), -1);
+				lp.addCoef(yikl(i, k, l), -1);
+				lp.addCoef(xikl(i, k, l), 2);
+				nCons += 2;
+			}
+		}
+	}
+
+	//sum Xjl (where j reads boundary value b) <= number of readers * Rbl
+	for(int b = 0; b < (int)bndReads.size(); b++) {
+		for(int l = 0; l < numParts; l++) {
+			lp.beginRow("", -LP_INF, 0);
+			for(int j : bndReads[b]) {
+				lp.addCoef(xij(j, l), 1);
+			}
+			lp.addCoef(rbl(b, l), -1 * (int)bndReads[b].size());
+			nCons++;
+		}
+	}
+
+	this->nIntParCons = nCons;
+	cout << "Total inter partition constraints " << nCons << endl;
+}
+
+//transaction row of partition k: values and load groups read by k
+void PartModel::addReadRow(int k) {
+	lp.beginRow("rd" + to_string(k), 0, TSize);
+	//sum over all vertices
+	for(int i = 0; i < numVertices; i++) {
+		//for reads.. p < k sum all Xipk
+		for(int p = 0; p < k; p++) {
+			lp.addCoef(xikl(i, p, k), 1);
+		}
+	}
+
+	//for loads consider for this partition k, or the next one when they are prefetched during k
+	int lk = hoistLoads ? k + 1 : k;
+	for(auto elem : lpgMap) {
+		if(lk < numParts) lp.addCoef(elem.second[lk], 1);
+	}
+
+	//boundary values read in partition k
+	for(int b = 0; b < (int)bndReads.size(); b++) {
+		lp.addCoef(rbl(b, k), 1);
+	}
+	readRowDone[k] = 1;
+}
+
+//transaction row of partition k: values and store groups written by k
+void PartModel::addWriteRow(int k) {
+	lp.beginRow("wr" + to_string(k), 0, TSize);
+	//sum over all vertices
+	for(int i = 0; i < numVertices; i++) {
+		//for writes : p > k
+		for(int p = k + 1; p < numParts; p++) {
+			lp.addCoef(xikl(i, k, p), 1);
+		}
+	}
+
+	//for stores consider for this partition k
+	for(auto elem : lpsMap) {
+		lp.addCoef(elem.second[k], 1);
+	}
+
+	//values read after the model's partitions are written from wherever they are produced
+	for(int i : bndWrites) {
+		lp.addCoef(xij(i, k), 1);
+	}
+	writeRowDone[k] = 1;
+}
+
+void PartModel::addTransCons() {
+	int nCons = 0;
+	readRowDone.assign(numParts, 0);
+	writeRowDone.assign(numParts, 0);
+
+	//the loads of partition 0 are prefetched before anything runs, or during the partition before a
+	//window, a core row in lazy mode too
+	if(hoistLoads) {
+		lp.beginRow("pf0", 0, TSize - bndPrefetch);
+		for(auto elem : lpgMap) {
+			lp.addCoef(elem.second[0], 1);
+		}
+		nCons++;
+	}
+	if(lazy) {
+		cout << "Transaction constraint rows deferred" << endl;
+		return;
+	}
+
+	//for reads transaction constraints..for reads k starts from 1 but 0 should be considered for loads
+	for(int k = 0; k < numParts; k++) {
+		addReadRow(k);
+		nCons++;
+	}
+
+	//for writes constraints..for writes k starts from 0 to p - 2 but p - 1 should be considered for stores
+	for(int k = 0; k < numParts; k++) {
+		addWriteRow(k);
+		nCons++;
+	}
+
+	this->nTransCons = nCons;
+	cout << "Number of transaction constraint rows added " << nCons << endl;
+}
+
+//i is resident in l if it is mapped before l and some successor s at or after l:
+//Sil >= sum(k < l) Xik + sum(j >= l) Xsj - 1 for every successor s
+void PartModel::addScratchCons() {
+	if(SPSize == INT_MAX) {
+		return;
+	}
+	int nCons = 0;
+	vector<int> sBase(numVertices, -1);
+	for(int i = 0; i < numVertices; i++) {
+		if(succs[i].empty()) continue;
+		sBase[i] = lp.getNumCols();
+		for(int l = 1; l < numParts; l++) {
+			lp.addBinCol("s" + to_string(i) + "," + to_string(l));
+		}
+		for(int s : succs[i]) {
+			for(int l = 1; l < numParts; l++) {
+				lp.beginRow("sp" + to_string(i) + "_" + to_string(s) + "_" + to_string(l), -LP_INF, 1);
+				for(int k = 0; k < l; k++) {
+					lp.addCoef(xij(i, k), 1);
+				}
+				for(int j = l; j < numParts; j++) {
+					lp.addCoef(xij(s, j), 1);
+				}
+				lp.addCoef(sBase[i] + l - 1, -1);
+				nCons++;
+			}
+		}
+	}
+	for(int l = 1; l < numParts; l++) {
+		lp.beginRow("spcap" + to_string(l), 0, SPSize);
+		for(int i = 0; i < numVertices; i++) {
+			if(sBase[i] >= 0) lp.addCoef(sBase[i] + l - 1, 1);
+		}
+		nCons++;
+	}
+	cout << "Number of scratchpad constraint rows added " << nCons << endl;
+}
+
+int PartModel::separate(const vector<int> &part) {
+	int before = lp.getNumRows();
+	vector<int> reads(numParts, 0), writes(numParts, 0);
+	vector<int> later; //distinct later partitions using a value
+	for(int i = 0; i < numVertices; i++) {
+		int k = part[i];
+		later.clear();
+		for(int s : succs[i]) {
+			if(part[s] > k) later.push_back(part[s]);
+		}
+		sort(later.begin(), later.end());
+		later.erase(unique(later.begin(), later.end()), later.end());
+		for(int l : later) {
+			if(!pairRowDone[i * nPairs + pairIdx(k, l)]) {
+				addPairRows(i, k, l);
+			}
+			writes[k]++;
+			reads[l]++;
+		}
+	}
+
+	//activity of the transaction rows with every other variable at the value the solution implies
+	for(auto &grp : loadGroups) {
+		set<int> pts;
+		for(int v : grp.second) pts.insert(part[v]);
+		for(int p : pts) {
+			if(!hoistLoads) reads[p]++;
+			else if(p > 0) reads[p - 1]++; //partition 0 has its own prefetch row
+		}
+	}
+	for(auto &grp : storeGroups) {
+		set<int> pts;
+		for(int v : grp.second) pts.insert(part[v]);
+		for(int p : pts) writes[p]++;
+	}
+	for(auto &rd : bndReads) {
+		set<int> pts;
+		for(int v : rd) pts.insert(part[v]);
+		for(int p : pts) reads[p]++;
+	}
+	for(int i : bndWrites) {
+		writes[part[i]]++;
+	}
+	for(int k = 0; k < numParts; k++) {
+		if(reads[k] > TSize && !readRowDone[k]) {
+			addReadRow(k);
+		}
+		if(writes[k] > TSize && !writeRowDone[k]) {
+			addWriteRow(k);
+		}
+	}
+	return lp.getNumRows() - before;
+}
+
+//load store reuse constraints
+void PartModel::addLoadStoreReuse() {
+	int nCons = 0;
+	//merge load and store maps as constraints have to be defined for all
+	map<int, vector<int>> allLSMap;
+	allLSMap.insert(lpgMap.begin(), lpgMap.end());
+	allLSMap.insert(lpsMap.begin(), lpsMap.end());
+
+	//merge load store groups
+	map<int, vector<int>> allLSGroups;
+	allLSGroups.insert(loadGroups.begin(), loadGroups.end());
+	allLSGroups.insert(storeGroups.begin(), storeGroups.end());
+
+	for(auto elem : allLSGroups) {
+		int group_id = elem.first;
+		//two equations for each partition for a given load or store group
+		for(int p = 0; p < numParts; p++) {
+			//negative sum all Xlp where ld is load or store plus Lp
+			lp.beginRow("", -LP_INF, 0);
+			for(int ld : elem.second) {
+				lp.addCoef(xij(ld, p), -1);
+			}
+			lp.addCoef(allLSMap[group_id][p], 1);
+
+			//positive sum all Xlp where ld is load or store minus num of loads * lp
+			lp.beginRow("", -LP_INF, 0);
+			for(int ld : elem.second) {
+				lp.addCoef(xij(ld, p), 1);
+			}
+			lp.addCoef(allLSMap[group_id][p], -1 * (int)elem.second.size());
+			nCons += 2;
+		}
+	}
+	this->nLdStCons = nCons;
+}
+
+//function to print all variables and row constraints
+void PartModel::printVarCons() {
+	cout << "Model Inputs " <<  graph.getNumNodes() << " ";
+	cout << graph.getNumEdges() << " ";
+	cout << Vout << " ";
+	cout << numLoads <<  " ";
+	cout << numStores << " ";
+	cout << loadGroups.size() << " ";
+	cout << storeGroups.size() << endl;
+
+	int coded_tot = 0; // summation of cols expected followed by coded
+	int expected_tot = 0;
+	int expected_Xij = numVertices * numParts; // V * P
+	cout << "Model size variables " << expected_Xij << " " << nXij << " ";
+	expected_tot += expected_Xij;
+	coded_tot += nXij;
+
+	int expectedLp = (storeGroups.size() + loadGroups.size()) * numParts; //G * P
+	cout << expectedLp << " " << nLp << " ";
+	coded_tot += nLp;
+	expected_tot += expectedLp;
+
+	int expectedInPa = Vout * numParts * (numParts - 1); //2 * Vout * P * (P - 1) / 2
+	cout << expectedInPa << " " << nInPa << " ";
+	coded_tot += nInPa;
+	expected_tot += expectedInPa;
+
+	cout << expected_tot << " 0 " << coded_tot << endl;
+
+	coded_tot = 0; //summation of rows expected followed by coded
+	expected_tot = 0;
+	int expectedUnq = numVertices; //V
+	cout << "Model size rows " << expectedUnq << " " << nUniqCons << " ";
+	coded_tot += nUniqCons;
+	expected_tot += expectedUnq;
+
+	int expectedCap = numParts; //P
+	cout << expectedCap << " " << nCapCons << " ";
+	coded_tot += nCapCons;
+	expected_tot += expectedCap;
+
+	int expectedPrec = graph.getNumEdges(); //E
+	cout << expectedPrec << " " << nPrecCons << " ";
+	coded_tot += nPrecCons;
+	expected_tot += expectedPrec;
+
+	int expectedInt = 2 * Vout * numParts * (numParts - 1);//2 * vout * P * (P-1)
+	cout << expectedInt << " " << nIntParCons << " ";
+	coded_tot += nIntParCons;
+	expected_tot += expectedInt;
+
+	int expectedLdSt = 2 * numParts * (storeGroups.size() + loadGroups.size()); // 2 * P * G
+	cout << expectedLdSt << " " << nLdStCons << " ";
+	expected_tot += expectedLdSt;
+	coded_tot += nLdStCons;
+
+	int expectedTrans = 2 * numParts; //2 * P
+	cout << expectedTrans << " " << nTransCons << " ";
+	expected_tot += expectedTrans;
+	coded_tot += nTransCons;
+	cout << expected_tot << " 0 " << coded_tot << " ";
+
+	cout << endl;
+}
@@ -0,0 +1,105 @@
+#include "PartResult.h"
+#include "PartEval.h"
+#include "DFGUtils.h"
+
+uint64_t graphHash(DAG &gp) {
+	uint64_t h = FNV_OFFSET;
+	int n = gp.getNumNodes();
+	vector<string> labels(n);
+	for(list<Node>::iterator it = gp.nodeBegin(); it != gp.nodeEnd(); it++) {
+		labels[it->getID()] = it->getLabel();
+	}
+	hashBytes(h, &n, sizeof(n));
+	for(auto &lb : labels) {
+		hashBytes(h, lb.c_str(), lb.size() + 1);
+	}
+	vector<pair<int, int>> edges;
+	for(list<Edge>::iterator it = gp.edgeBegin(); it != gp.edgeEnd(); it++) {
+		edges.push_back({(int)it->getSrcNodeID(), (int)it->getDestNodeID()});
+	}
+	sort(edges.begin(), edges.end());
+	for(auto &e : edges) {
+		hashBytes(h, &e.first, sizeof(int));
+		hashBytes(h, &e.second, sizeof(int));
+	}
+	return h;
+}
+
+PartResult makeResult(DAG &gp, const vector<int> &part, int numParts, const partLimits &lim) {
+	PartResult res;
+	res.graphHash = graphHash(gp);
+	res.numVertices = gp.getNumNodes();
+	res.numEdges = gp.getNumEdges();
+	res.RSize = lim.RSize;
+	res.TSize = lim.TSize;
+	res.loadWeight = lim.loadWeight;
+	res.pipelined = lim.pipelined;
+	res.spSize = lim.spSize;
+	res.fuTag = lim.fu.tag();
+	res.numParts = numParts;
+	res.part = part;
+	PartEval eval(gp, lim);
+	vector<partCounts> counts;
+	if(eval.validate(part, numParts, counts) == "") {
+		res.cost = eval.cost(counts);
+	}
+	return res;
+}
+
+string writePartResult(const string &fname, const PartResult &res) {
+	FILE *fp = fopen(fname.c_str(), "w");
+	if(fp == NULL) return "cannot open " + fname + " for writing";
+	fprintf(fp, "dfgpart 2\n");
+	fprintf(fp, "graph %016llx %d %d\n", (unsigned long long)res.graphHash, res.numVertices, res.numEdges);
+	fprintf(fp, "limits %d %d %d\n", res.RSize, res.TSize, res.loadWeight);
+	fprintf(fp, "mode %s spad %s fu %s\n", res.pipelined ? "pipelined" : "serial",
+		res.spSize == INT_MAX ? "-" : to_string(res.spSize).c_str(), res.fuTag.empty() ? "-" : res.fuTag.c_str());
+	fprintf(fp, "parts %d cost %ld\n", res.numParts, res.cost);
+	for(size_t v = 0; v < res.part.size(); v++) {
+		fprintf(fp, "%d%c", res.part[v], (v % 32 == 31 || v + 1 == res.part.size()) ? '\n' : ' ');
+	}
+	fclose(fp);
+	return "";
+}
+
+string readPartResult(const string &fname, PartResult &res) {
+	FILE *fp = fopen(fname.c_str(), "r");
+	if(fp == NULL) return "cannot open " + fname;
+	int version = 0;
+	unsigned long long hash = 0;
+	int ok = fscanf(fp, " dfgpart %d", &version) == 1;
+	ok = ok && fscanf(fp, " graph %llx %d %d", &hash, &res.numVertices, &res.numEdges) == 3;
+	ok = ok && fscanf(fp, " limits %d %d %d", &res.RSize, &res.TSize, &res.loadWeight) == 3;
+	char mode[16] = "serial", spad[16] = "-", fu[32] = "-";
+	if(ok && version == 2) {
+		ok = fscanf(fp, " mode %15s spad %15s fu %31s", mode, spad, fu) == 3;
+	}
+	ok = ok && fscanf(fp, " parts %d cost %ld", &res.numParts, &res.cost) == 2;
+	ok = ok && (string(mode) == "serial" || string(mode) == "pipelined");
+	char *end = NULL;
+	long cap = string(spad) == "-" ? INT_MAX : strtol(spad, &end, 10);
+	ok = ok && (end == NULL || *end == '\0') && cap >= 1 && cap <= INT_MAX;
+	if(!ok || (version != 1 && version != 2) || res.numVertices < 0) {
+		fclose(fp);
+		return fname + " is not a version 1 or 2 partition file";
+	}
+	if(res.numParts < 1 || res.numParts > res.numVertices) {
+		fclose(fp);
+		return fname + " has " + to_string(res.numParts) + " partitions for " + to_string(res.numVertices) + " vertices";
+	}
+	res.pipelined = string(mode) == "pipelined";
+	res.spSize = cap;
+	res.fuTag = string(fu) == "-" ? "" : fu;
+	res.graphHash = hash;
+	res.part.clear(); //grown as read, a bad vertex count ends at the end of the file
+	for(int v = 0; v < res.numVertices; v++) {
+		int p;
+		if(fscanf(fp, "%d", &p) != 1) {
+			fclose(fp);
+			return fname + " ends after " + to_string(v) + " of " + to_string(res.numVertices) + " vertices";
+		}
+		res.part.push_back(p);
+	}
+	fclose(fp);
+	return "";
+}
@@ -0,0 +1,176 @@
+#include "PartSched.h"
+#include "DFGAnaly.h"
+#include "DFGUtils.h"
+
+PartSched::PartSched(DAG &gp, CGRAConfig config, const LatencyTable &latTable) {
+	cfg = config;
+	cfg.fus = max(1, cfg.fus);
+	cfg.memPorts = max(1, cfg.memPorts);
+	numVertices = gp.getNumNodes();
+
+	DFGAnaly anl(gp);
+	anl.setLatencies(latTable);
+	lat = anl.latencies();
+	readLat = anl.opLatency("load");
+	writeLat = anl.opLatency("store");
+
+	isMem.assign(numVertices, 0);
+	for(list<Node>::iterator it = gp.nodeBegin(); it != gp.nodeEnd(); it++) {
+		isMem[it->getID()] = isLoadOp(it->getLabel()) || isStoreOp(it->getLabel());
+	}
+	succs.resize(numVertices);
+	preds.resize(numVertices);
+	for(list<Edge>::iterator it = gp.edgeBegin(); it != gp.edgeEnd(); it++) {
+		succs[it->getSrcNodeID()].push_back(it->getDestNodeID());
+		preds[it->getDestNodeID()].push_back(it->getSrcNodeID());
+	}
+	for(int v = 0; v < numVertices; v++) {
+		sort(succs[v].begin(), succs[v].end());
+		succs[v].erase(unique(succs[v].begin(), succs[v].end()), succs[v].end());
+		sort(preds[v].begin(), preds[v].end());
+		preds[v].erase(unique(preds[v].begin(), preds[v].end()), preds[v].end());
+	}
+}
+
+vector<partSched> PartSched::schedule(const vector<int> &part, int numParts, vector<int> &start) {
+	vector<vector<int>> members(numParts);
+	for(int v = 0; v < numVertices; v++) {
+		members[part[v]].push_back(v);
+	}
+	start.assign(numVertices, -1);
+	vector<partSched> scheds;
+
+	//operations of one partition: its vertices, then reads of outside values, then writes
+	vector<int> opOf(numVertices, -1), readOf(numVertices, -1);
+	for(int p = 0; p < numParts; p++) {
+		vector<int> opLat, opVert; //vertex of a vertex op, -1 for transfers
+		vector<char> opMem;
+		vector<vector<int>> opSuccs;
+		auto addOp = [&](int l, int v, bool mem) {
+			opLat.push_back(l);
+			opVert.push_back(v);
+			opMem.push_back(mem);
+			opSuccs.push_back(vector<int>());
+			return (int)opLat.size() - 1;
+		};
+		for(int v : members[p]) {
+			opOf[v] = addOp(lat[v], v, isMem[v]);
+		}
+		for(int v : members[p]) {
+			bool usedLater = false;
+			for(int s : succs[v]) {
+				if(part[s] == p) opSuccs[opOf[v]].push_back(opOf[s]);
+				else usedLater = true;
+			}
+			for(int u : preds[v]) {
+				if(part[u] == p) continue;
+				if(readOf[u] < 0) readOf[u] = addOp(readLat, -1, true);
+				opSuccs[readOf[u]].push_back(opOf[v]);
+			}
+			if(usedLater) {
+				int w = addOp(writeLat, -1, true);
+				opSuccs[opOf[v]].push_back(w);
+			}
+		}
+		for(int v : members[p]) {
+			for(int u : preds[v]) readOf[u] = -1;
+		}
+
+		//priority: latency-weighted path to the end of the partition
+		int n = opLat.size();
+		vector<int> npred(n, 0);
+		for(int o = 0; o < n; o++) {
+			for(int s : opSuccs[o]) npred[s]++;
+		}
+		vector<int> order;
+		vector<int> indeg(npred);
+		for(int o = 0; o < n; o++) {
+			if(indeg[o] == 0) order.push_back(o);
+		}
+		for(int h = 0; h < (int)order.size(); h++) {
+			for(int s : opSuccs[order[h]]) {
+				if(--indeg[s] == 0) order.push_back(s);
+			}
+		}
+		vector<int> height(n, 0);
+		for(int h = n - 1; h >= 0; h--) {
+			int o = order[h];
+			for(int s : opSuccs[o]) height[o] = max(height[o], height[s]);
+			height[o] += opLat[o];
+		}
+
+		//cycle by cycle issue; an op is pending until its operands are there, then ready
+		partSched ps = {0, (int)members[p].size(), 0, 0, 0, 1};
+		vector<int> earliest(n, 0);
+		priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pending; //earliest cycle, op
+		priority_queue<pair<int, int>> ready; //height, -op
+		for(int o = 0; o < n; o++) {
+			if(npred[o] == 0) pending.push({0, o});
+			if(opMem[o]) ps.memOps++;
+		}
+		int cycle = 0, issued = 0;
+		vector<pair<int, int>> held;
+		while(issued < n) {
+			while(!pending.empty() && pending.top().first <= cycle) {
+				ready.push({height[pending.top().second], -pending.top().second});
+				pending.pop();
+			}
+			if(ready.empty()) {
+				cycle = pending.top().first;
+				continue;
+			}
+			int fus = cfg.fus, ports = cfg.memPorts;
+			held.clear();
+			while(!ready.empty() && (fus > 0 || ports > 0)) {
+				pair<int, int> top = ready.top();
+				ready.pop();
+				int o = -top.second;
+				bool vert = opVert[o] >= 0;
+				if((vert && fus == 0) || (opMem[o] && ports == 0)) {
+					held.push_back(top);
+					continue;
+				}
+				if(vert) {
+					fus--;
+					start[opVert[o]] = cycle;
+				}
+				if(opMem[o]) ports--;
+				issued++;
+				int finish = cycle + opLat[o];
+				ps.length = max(ps.length, finish);
+				for(int s : opSuccs[o]) {
+					earliest[s] = max(earliest[s], finish);
+					if(--npred[s] == 0) pending.push({earliest[s], s});
+				}
+			}
+			for(auto &h : held) ready.push(h);
+			cycle++;
+		}
+
+		if(ps.length > 0) {
+			ps.fuUtil = double(ps.ops) / ((double)ps.length * cfg.fus);
+			ps.memUtil = double(ps.memOps) / ((double)ps.length * cfg.memPorts);
+		}
+		//resource bound of a modulo schedule, a partition has no recurrences of its own
+		ps.II = max(1, max((ps.ops + cfg.fus - 1) / cfg.fus, (ps.memOps + cfg.memPorts - 1) / cfg.memPorts));
+		scheds.push_back(ps);
+	}
+	return scheds;
+}
+
+long PartSched::totalCycles(const vector<partSched> &scheds) {
+	long total = 0;
+	for(auto &ps : scheds) {
+		total += ps.length;
+	}
+	return total;
+}
+
+void PartSched::printScheds(const vector<partSched> &scheds) const {
+	for(size_t p = 0; p < scheds.size(); p++) {
+		const partSched &ps = scheds[p];
+		cout << "Partition " << p << " length " << ps.length << " cycles ops " << ps.ops << " memory accesses " << ps.memOps
+			<< " FU utilization " << 100 * ps.fuUtil << "% port utilization " << 100 * ps.memUtil << "% II " << ps.II << endl;
+	}
+	cout << "Schedule length " << totalCycles(scheds) << " cycles on " << cfg.fus << " FUs and " << cfg.memPorts << " memory ports" << endl;
+}
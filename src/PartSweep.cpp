@@ -0,0 +1,169 @@
+#include "PartSweep.h"
+#include "DFGUtils.h"
+#include <unistd.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#define EXIT_MEMOUT 3 //child ran out of its address space limit
+
+static vector<int> parseList(const string &s) {
+	vector<int> vals;
+	stringstream ss(s);
+	string item;
+	while(getline(ss, item, ',')) {
+		if(!item.empty()) vals.push_back(atoi(item.c_str()));
+	}
+	return vals;
+}
+
+void PartSweep::addGraph(const string &fname) {
+	try {
+		DAG gp(fname);
+		gp.setName(fname);
+		graphs.push_back(gp);
+		names.push_back(fname);
+	} catch(string ex) {
+		cout << "Skipping " << fname << ": " << ex << endl;
+	}
+}
+
+bool PartSweep::parseArgs(int argc, char **argv, int first) {
+	for(int a = first; a < argc; a++) {
+		string opt = argv[a];
+		bool hasVal = a + 1 < argc;
+		if(opt == "-R" && hasVal) RSizes = parseList(argv[++a]);
+		else if(opt == "-T" && hasVal) TSizes = parseList(argv[++a]);
+		else if(opt == "-L" && hasVal) loadWeights = parseList(argv[++a]);
+		else if(opt == "-jobs" && hasVal) jobs = atoi(argv[++a]);
+		else if(opt == "-time" && hasVal) timeLimit = atof(argv[++a]);
+		else if(opt == "-mem" && hasVal) memLimitMB = atol(argv[++a]);
+		else if(opt == "-out" && hasVal) outName = argv[++a];
+		else if(opt[0] == '-') {
+			cout << "Unknown option " << opt << endl;
+			graphs.clear();
+			break;
+		}
+		else {
+			vector<string> files;
+			collectDotFiles(opt, files);
+			for(auto &f : files) addGraph(f);
+		}
+	}
+	if(graphs.empty() || RSizes.empty() || TSizes.empty()) {
+		cout << "Usage: <dot files|dirs|lists>... -R <sizes> -T <trans limits> [-L <load weights>] [-jobs n] [-time secs] [-mem MB] [-out csv]" << endl;
+		return false;
+	}
+	if(loadWeights.empty()) loadWeights.push_back(1);
+	return true;
+}
+
+int PartSweep::run(SweepSolver solver) {
+	typedef struct Job {int g, R, T, L;} Job;
+	vector<Job> jobList;
+	for(int g = 0; g < (int)graphs.size(); g++) {
+		for(int R : RSizes) for(int T : TSizes) for(int L : loadWeights) jobList.push_back({g, R, T, L});
+	}
+	int nJobs = jobs > 0 ? jobs : max(1, (int)thread::hardware_concurrency());
+
+	bool fresh = access(outName.c_str(), F_OK) != 0;
+	ofstream out(outName, ios::app);
+	if(fresh) {
+		out << "graph,vertices,edges,RSize,TSize,loadWeight,status,partitions,iterations,objective,rows,cols,seconds,peak_kb" << endl;
+	}
+	cout << "Sweeping " << jobList.size() << " jobs over " << graphs.size() << " graphs with " << nJobs << " at a time" << endl;
+
+	typedef struct Running {int job; int fd; chrono::steady_clock::time_point start;} Running;
+	map<pid_t, Running> running;
+	size_t next = 0;
+	int solved = 0, done = 0;
+	while(next < jobList.size() || !running.empty()) {
+		while(next < jobList.size() && (int)running.size() < nJobs) {
+			Job &jb = jobList[next];
+			int fds[2];
+			if(pipe(fds) != 0) {
+				cout << "Cannot create pipe" << endl;
+				return solved;
+			}
+			fflush(stdout);
+			cout.flush();
+			pid_t pid = fork();
+			if(pid == 0) {
+				close(fds[0]);
+				if(timeLimit > 0) {
+					rlim_t cpu = (rlim_t)ceil(timeLimit) + 1;
+					struct rlimit rl = {cpu, cpu + 1};
+					setrlimit(RLIMIT_CPU, &rl);
+					alarm((unsigned)ceil(timeLimit)); //wall clock, default action ends the job
+				}
+				if(memLimitMB > 0) {
+					rlim_t bytes = (rlim_t)memLimitMB << 20;
+					struct rlimit rl = {bytes, bytes};
+					setrlimit(RLIMIT_AS, &rl);
+				}
+				int nul = open("/dev/null", O_WRONLY);
+				dup2(nul, STDOUT_FILENO);
+
+				SweepRecord rec;
+				bool ok = false;
+				auto start = chrono::steady_clock::now();
+				try {
+					ok = solver(graphs[jb.g], jb.R, jb.T, jb.L, rec);
+				} catch(bad_alloc &ex) {
+					_exit(EXIT_MEMOUT);
+				}
+				rec.secs = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count() / 1000.0;
+				char line[256];
+				int len = snprintf(line, sizeof(line), "%s %d %d %.6g %d %d %.3f\n", ok ? "ok" : "infeasible", rec.numParts,
+					rec.iteration, rec.objective, rec.rows, rec.cols, rec.secs);
+				if(write(fds[1], line, len) != len) _exit(1);
+				_exit(0);
+			}
+			close(fds[1]);
+			running[pid] = Running{(int)next, fds[0], chrono::steady_clock::now()};
+			next++;
+		}
+
+		int status = 0;
+		struct rusage ru;
+		pid_t pid = wait4(-1, &status, 0, &ru);
+		if(pid < 0) break;
+		auto it = running.find(pid);
+		if(it == running.end()) continue;
+		Job &jb = jobList[it->second.job];
+
+		SweepRecord rec;
+		char line[256] = {0};
+		ssize_t len = read(it->second.fd, line, sizeof(line) - 1);
+		close(it->second.fd);
+		char st[32];
+		if(WIFEXITED(status) && WEXITSTATUS(status) == 0 && len > 0 &&
+			sscanf(line, "%31s %d %d %lf %d %d %lf", st, &rec.numParts, &rec.iteration, &rec.objective, &rec.rows, &rec.cols, &rec.secs) == 7) {
+			rec.status = st;
+		}
+		else if(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_MEMOUT) {
+			rec.status = "memout";
+		}
+		else if(WIFSIGNALED(status) && (WTERMSIG(status) == SIGXCPU || WTERMSIG(status) == SIGALRM || WTERMSIG(status) == SIGKILL)) {
+			rec.status = "timeout";
+		}
+		else {
+			rec.status = "crashed";
+		}
+		if(rec.status != "ok" && rec.status != "infeasible") { //the job could not report its own time
+			rec.secs = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - it->second.start).count() / 1000.0;
+		}
+		rec.peakKB = ru.ru_maxrss;
+		solved += rec.status == "ok";
+		done++;
+
+		out << names[jb.g] << "," << graphs[jb.g].getNumNodes() << "," << graphs[jb.g].getNumEdges() << "," << jb.R << "," << jb.T << "," << jb.L << ","
+			<< rec.status << "," << rec.numParts << "," << rec.iteration << "," << rec.objective << "," << rec.rows << "," << rec.cols << ","
+			<< rec.secs << "," << rec.peakKB << endl;
+		cout << "[" << done << "/" << jobList.size() << "] " << names[jb.g] << " " << jb.R << " " << jb.T << " " << jb.L << " " << rec.status
+			<< " " << rec.numParts << " " << rec.objective << " " << rec.secs << endl;
+		running.erase(it);
+	}
+	return solved;
+}
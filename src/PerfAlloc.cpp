@@ -0,0 +1,42 @@
+#include "PerfTrace.h"
+#include <new>
+#include <cstdlib>
+
+//global operator new counting, only in binaries linked with PerfAlloc.o (make PERF_ALLOC=PerfAlloc.o)
+static bool hooked = PerfTrace::hookAllocs();
+
+void *operator new(size_t sz) {
+	PerfTrace::countAlloc(sz);
+	void *p = malloc(sz ? sz : 1);
+	if(p == NULL) throw bad_alloc();
+	return p;
+}
+
+void *operator new[](size_t sz) {
+	return operator new(sz);
+}
+
+void *operator new(size_t sz, const nothrow_t &) noexcept {
+	PerfTrace::countAlloc(sz);
+	return malloc(sz ? sz : 1);
+}
+
+void *operator new[](size_t sz, const nothrow_t &nt) noexcept {
+	return operator new(sz, nt);
+}
+
+void operator delete(void *p) noexcept {
+	free(p);
+}
+
+void operator delete[](void *p) noexcept {
+	free(p);
+}
+
+void operator delete(void *p, const nothrow_t &) noexcept {
+	free(p);
+}
+
+void operator delete[](void *p, const nothrow_t &) noexcept {
+	free(p);
+}
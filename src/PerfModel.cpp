@@ -0,0 +1,98 @@
+#include "PerfModel.h"
+#include "DFGUtils.h"
+
+PerfModel::PerfModel(DAG &gp, perfParams params) : prm(params), sched(gp, params.cgra, params.latencies), eval(gp, partLimits()) {
+	prm.batch = max(1, prm.batch);
+	isLoad.assign(gp.getNumNodes(), 0);
+	isStore.assign(gp.getNumNodes(), 0);
+	for(list<Node>::iterator it = gp.nodeBegin(); it != gp.nodeEnd(); it++) {
+		isLoad[it->getID()] = isLoadOp(it->getLabel());
+		isStore[it->getID()] = isStoreOp(it->getLabel());
+	}
+}
+
+perfEstimate PerfModel::estimate(const vector<int> &part, int numParts) {
+	vector<int> start;
+	vector<partSched> scheds = sched.schedule(part, numParts, start);
+	vector<partCounts> counts;
+	eval.validate(part, numParts, counts); //only the counts, the limits are off
+	vector<long> loadWords(numParts, 0), storeWords(numParts, 0);
+	for(size_t v = 0; v < part.size(); v++) {
+		if(isLoad[v]) loadWords[part[v]]++;
+		if(isStore[v]) storeWords[part[v]]++;
+	}
+
+	perfEstimate est;
+	est.cycles = 0;
+	double batchTotal = 0;
+	vector<long> prefetch(numParts + 1, 0), exec(numParts, 0), execBatch(numParts, 0); //pipelined mode
+	for(int p = 0; p < numParts; p++) {
+		partPerf pp;
+		pp.compute = scheds[p].length;
+		pp.II = scheds[p].II;
+		pp.dramIn = counts[p].loads * prm.dramLat + (int)ceil(loadWords[p] / prm.dramBW);
+		pp.dramOut = counts[p].stores * prm.dramLat + (int)ceil(storeWords[p] / prm.dramBW);
+		pp.cycles = (long)prm.reconfig + pp.dramIn + pp.compute + pp.dramOut;
+		prefetch[p] = (long)prm.reconfig + pp.dramIn;
+		exec[p] = pp.compute + pp.dramOut;
+		execBatch[p] = exec[p] + (long)(prm.batch - 1) * max(pp.II, pp.dramIn + pp.dramOut);
+		est.cycles += pp.cycles;
+		batchTotal += pp.cycles + (double)(prm.batch - 1) * (pp.dramIn + pp.II + pp.dramOut);
+		est.parts.push_back(pp);
+	}
+	if(prm.pipelined && numParts > 0) {
+		//partition p runs while p + 1 is prefetched; in steady state partition 0 of the next
+		//invocation is prefetched during the last one
+		est.cycles = prefetch[0];
+		batchTotal = 0;
+		for(int p = 0; p < numParts; p++) {
+			est.parts[p].cycles = max(exec[p], prefetch[p + 1]);
+			est.cycles += est.parts[p].cycles;
+			batchTotal += max(execBatch[p], prefetch[(p + 1) % numParts]);
+		}
+	}
+	est.batchCycles = batchTotal / prm.batch;
+	return est;
+}
+
+string PerfModel::tag() const {
+	ostringstream os;
+	os << prm.cgra.fus << "_" << prm.cgra.memPorts << "_" << prm.reconfig << "_" << prm.dramBW << "_" << prm.dramLat << "_" << prm.batch << (prm.pipelined ? "_pipe" : "");
+	return os.str();
+}
+
+void PerfModel::printEstimate(const perfEstimate &est) const {
+	for(size_t p = 0; p < est.parts.size(); p++) {
+		const partPerf &pp = est.parts[p];
+		cout << "Partition " << p << " reconfig " << prm.reconfig << " DRAM in " << pp.dramIn << " compute " << pp.compute
+			<< " DRAM out " << pp.dramOut << " cycles " << pp.cycles << " II " << pp.II << endl;
+	}
+	cout << "Estimated " << est.cycles << (prm.pipelined ? " pipelined" : "") << " cycles per invocation, " << est.batchCycles << " per invocation in batches of "
+		<< prm.batch << ", throughput " << (est.batchCycles > 0 ? 1e6 / est.batchCycles : 0.0) << " invocations per million cycles" << endl;
+}
+
+perfParams parsePerfParams(const string &spec, perfParams base) {
+	perfParams prm = base;
+	stringstream ss(spec);
+	string item;
+	while(getline(ss, item, ',')) {
+		if(item.empty()) continue;
+		size_t eq = item.find('=');
+		string key = item.substr(0, eq);
+		char *end = NULL;
+		const char *val = eq == string::npos ? "" : item.c_str() + eq + 1;
+		double x = strtod(val, &end);
+		if(eq == string::npos || *val == 0 || *end || x < 0) {
+			throw string("Bad performance parameter ") + item;
+		}
+		if(key == "fus") prm.cgra.fus = (int)x;
+		else if(key == "ports") prm.cgra.memPorts = (int)x;
+		else if(key == "reconfig") prm.reconfig = (int)x;
+		else if(key == "dram_bw" && x > 0) prm.dramBW = x;
+		else if(key == "dram_lat") prm.dramLat = (int)x;
+		else if(key == "batch") prm.batch = (int)x;
+		else if(key == "pipeline") prm.pipelined = x != 0;
+		else throw string("Bad performance parameter ") + item;
+	}
+	return prm;
+}
@@ -0,0 +1,187 @@
+#include "PerfTrace.h"
+#include <atomic>
+#include <mutex>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <vector>
+
+//allocation counters, only advanced when PerfAlloc.o replaces operator new
+static atomic<long> nAllocs(0);
+static atomic<long> nAllocBytes(0);
+static atomic<bool> allocHook(false);
+
+//trace state, opened lazily from the environment
+static mutex traceMtx;
+static FILE *traceFp = NULL;
+static once_flag traceOnce;
+static atomic<bool> traceOn(false); //traceFp is open, read without the lock
+static string traceCtx;
+static vector<PerfScope *> openScopes; //phases whose peak RSS a reset must not lose
+static bool hwmResets = true; //false once clear_refs failed, peaks are then sampled at the ends
+
+static void initTrace() {
+	const char *env = getenv("DFG_PERF_TRACE");
+	if(env != NULL && *env) traceFp = fopen(env, "a");
+	traceOn.store(traceFp != NULL, memory_order_release);
+}
+
+static FILE *traceFile() {
+	call_once(traceOnce, initTrace);
+	return traceFp;
+}
+
+void PerfTrace::open(const string &fname) {
+	lock_guard<mutex> lk(traceMtx);
+	if(traceFile() != NULL) fclose(traceFp);
+	traceFp = fopen(fname.c_str(), "a");
+	traceOn.store(traceFp != NULL, memory_order_release);
+}
+
+bool PerfTrace::enabled() {
+	call_once(traceOnce, initTrace);
+	return traceOn.load(memory_order_acquire);
+}
+
+void PerfTrace::setContext(const string &ctx) {
+	lock_guard<mutex> lk(traceMtx);
+	traceCtx = ctx;
+}
+
+string PerfTrace::quote(const string &s) {
+	string q = "\"";
+	for(char c : s) {
+		if(c == '"' || c == '\\') q += '\\';
+		if((unsigned char)c < 0x20) {
+			char buf[8];
+			snprintf(buf, sizeof(buf), "\\u%04x", c);
+			q += buf;
+			continue;
+		}
+		q += c;
+	}
+	return q + "\"";
+}
+
+void PerfTrace::emit(const string &json) {
+	lock_guard<mutex> lk(traceMtx);
+	FILE *fp = traceFile();
+	if(fp == NULL) return;
+	fputs(json.c_str(), fp);
+	fputc('\n', fp);
+	fflush(fp);
+}
+
+void PerfTrace::counter(const string &name, long value) {
+	if(!enabled()) return;
+	string ctx;
+	{
+		lock_guard<mutex> lk(traceMtx);
+		ctx = traceCtx;
+	}
+	emit("{\"counter\":" + quote(name) + ",\"context\":" + quote(ctx) + ",\"value\":" + to_string(value) + "}");
+}
+
+bool PerfTrace::hookAllocs() {
+	allocHook.store(true);
+	return true;
+}
+
+bool PerfTrace::countingAllocs() {
+	return allocHook.load(memory_order_relaxed);
+}
+
+void PerfTrace::countAlloc(size_t bytes) {
+	nAllocs.fetch_add(1, memory_order_relaxed);
+	nAllocBytes.fetch_add(bytes, memory_order_relaxed);
+}
+
+long PerfTrace::allocCount() {
+	return nAllocs.load(memory_order_relaxed);
+}
+
+long PerfTrace::allocBytes() {
+	return nAllocBytes.load(memory_order_relaxed);
+}
+
+long PerfTrace::peakRSSKB() {
+	long kb = 0;
+	char line[256];
+	FILE *fp = fopen("/proc/self/status", "r");
+	if(fp != NULL) {
+		while(fgets(line, sizeof(line), fp) != NULL) {
+			if(sscanf(line, "VmHWM: %ld", &kb) == 1) break;
+		}
+		fclose(fp);
+	}
+	if(kb == 0) { //no procfs, the peak of the whole process
+		struct rusage ru;
+		getrusage(RUSAGE_SELF, &ru);
+		kb = ru.ru_maxrss;
+	}
+	return kb;
+}
+
+bool PerfTrace::resetPeakRSS() {
+	FILE *fp = fopen("/proc/self/clear_refs", "w");
+	if(fp == NULL) return false;
+	bool ok = fputs("5", fp) >= 0;
+	return fclose(fp) == 0 && ok;
+}
+
+long PerfTrace::currentRSSKB() {
+	long pages = 0, resident = 0;
+	FILE *fp = fopen("/proc/self/statm", "r");
+	if(fp == NULL) return 0;
+	if(fscanf(fp, "%ld %ld", &pages, &resident) != 2) resident = 0;
+	fclose(fp);
+	return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+//Starting a phase resets the kernel high water mark to the current RSS, so the peaks reached by
+//the phases still open are folded into them first.
+PerfScope::PerfScope(const char *name) {
+	phase = name;
+	allocs0 = PerfTrace::allocCount();
+	bytes0 = PerfTrace::allocBytes();
+	rss0 = peak = 0;
+	if(PerfTrace::enabled()) {
+		lock_guard<mutex> lk(traceMtx);
+		if(hwmResets) {
+			long hwm = PerfTrace::peakRSSKB();
+			for(PerfScope *ps : openScopes) ps->notePeak(hwm);
+			hwmResets = PerfTrace::resetPeakRSS();
+		}
+		rss0 = peak = PerfTrace::currentRSSKB();
+		openScopes.push_back(this);
+	}
+	start = chrono::steady_clock::now();
+}
+
+PerfScope::~PerfScope() {
+	double ms = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count() / 1000.0;
+	if(!PerfTrace::enabled()) return;
+	long rss = PerfTrace::currentRSSKB();
+	string ctx;
+	{
+		lock_guard<mutex> lk(traceMtx);
+		ctx = traceCtx;
+		if(hwmResets) {
+			long hwm = PerfTrace::peakRSSKB();
+			for(PerfScope *ps : openScopes) ps->notePeak(hwm);
+		}
+		openScopes.erase(remove(openScopes.begin(), openScopes.end(), this), openScopes.end());
+	}
+	notePeak(rss);
+	char nums[256];
+	if(PerfTrace::countingAllocs()) {
+		snprintf(nums, sizeof(nums), ",\"ms\":%.3f,\"allocs\":%ld,\"alloc_bytes\":%ld,\"rss_kb\":%ld,\"rss_delta_kb\":%ld,\"peak_rss_kb\":%ld}",
+			ms, PerfTrace::allocCount() - allocs0, PerfTrace::allocBytes() - bytes0, rss, rss - rss0, peak);
+	}
+	else {
+		snprintf(nums, sizeof(nums), ",\"ms\":%.3f,\"rss_kb\":%ld,\"rss_delta_kb\":%ld,\"peak_rss_kb\":%ld}", ms, rss, rss - rss0, peak);
+	}
+	PerfTrace::emit("{\"phase\":" + PerfTrace::quote(phase) + ",\"context\":" + PerfTrace::quote(ctx) + nums);
+}
@@ -0,0 +1,157 @@
+#include "ReachIndex.h"
+
+ReachIndex::ReachIndex(DAG &gp, size_t maxBytes) {
+	numVertices = gp.getNumNodes();
+	vector<vector<int>> succs(numVertices);
+	for(list<Edge>::iterator it = gp.edgeBegin(); it != gp.edgeEnd(); it++) {
+		succs[it->getSrcNodeID()].push_back(it->getDestNodeID());
+	}
+	succBeg.assign(numVertices + 1, 0);
+	vector<int> indeg(numVertices, 0);
+	for(int v = 0; v < numVertices; v++) {
+		sort(succs[v].begin(), succs[v].end());
+		succs[v].erase(unique(succs[v].begin(), succs[v].end()), succs[v].end());
+		succBeg[v + 1] = succBeg[v] + succs[v].size();
+		for(int s : succs[v]) {
+			succList.push_back(s);
+			indeg[s]++;
+		}
+	}
+	for(int v = 0; v < numVertices; v++) {
+		if(indeg[v] == 0) order.push_back(v);
+	}
+	for(int h = 0; h < (int)order.size(); h++) {
+		int v = order[h];
+		for(int k = succBeg[v]; k < succBeg[v + 1]; k++) {
+			if(--indeg[succList[k]] == 0) order.push_back(succList[k]);
+		}
+	}
+	topoRank.assign(numVertices, 0);
+	for(int h = 0; h < numVertices; h++) topoRank[order[h]] = h;
+
+	//the closure with the counts if it fits, otherwise labels and counts on demand
+	size_t rowWords = (numVertices + 63) / 64;
+	if(rowWords * numVertices * 8 <= maxBytes) {
+		W = rowWords;
+		ancCnt.assign(numVertices, 0);
+		descCnt.assign(numVertices, 0);
+		countBlock(0, numVertices, closure);
+	}
+	else {
+		buildLabels();
+	}
+	blockBytes = maxBytes;
+}
+
+//closure one block of columns at a time
+void ReachIndex::computeCounts() {
+	ancCnt.assign(numVertices, 0);
+	descCnt.assign(numVertices, 0);
+	size_t rowWords = (numVertices + 63) / 64;
+	size_t blockWords = max((size_t)1, min(rowWords, blockBytes / 8 / max(1, numVertices)));
+	vector<uint64_t> rows;
+	for(size_t w0 = 0; w0 < rowWords; w0 += blockWords) {
+		countBlock(w0 * 64, min((size_t)numVertices, (w0 + blockWords) * 64), rows);
+	}
+}
+
+//descendants of every vertex among columns c0..c1-1, counted into descCnt and ancCnt
+void ReachIndex::countBlock(int c0, int c1, vector<uint64_t> &rows) {
+	int bw = (c1 - c0 + 63) / 64;
+	rows.assign((size_t)numVertices * bw, 0);
+	for(int h = numVertices - 1; h >= 0; h--) {
+		int v = order[h];
+		uint64_t *row = &rows[(size_t)v * bw];
+		for(int k = succBeg[v]; k < succBeg[v + 1]; k++) {
+			int s = succList[k];
+			orWords(row, &rows[(size_t)s * bw], bw);
+			if(s >= c0 && s < c1) setBit(row, s - c0);
+		}
+		for(int w = 0; w < bw; w++) {
+			uint64_t bits = row[w];
+			descCnt[v] += __builtin_popcountll(bits);
+			while(bits) {
+				ancCnt[c0 + w * 64 + __builtin_ctzll(bits)]++;
+				bits &= bits - 1;
+			}
+		}
+	}
+}
+
+void ReachIndex::buildLabels() {
+	mt19937 rng(12345);
+	vector<int> roots;
+	vector<int> indeg(numVertices, 0);
+	for(int s : succList) indeg[s]++;
+	for(int v = 0; v < numVertices; v++) {
+		if(indeg[v] == 0) roots.push_back(v);
+	}
+	for(int l = 0; l < nLabels; l++) {
+		lo[l].assign(numVertices, INT_MAX);
+		post[l].assign(numVertices, -1);
+		vector<int> children(succList);
+		for(int v = 0; v < numVertices; v++) {
+			shuffle(children.begin() + succBeg[v], children.begin() + succBeg[v + 1], rng);
+		}
+		vector<int> rootOrder(roots);
+		shuffle(rootOrder.begin(), rootOrder.end(), rng);
+
+		//iterative post order DFS, lo is the smallest post order number below a vertex
+		int counter = 0;
+		vector<pair<int, int>> stk; //vertex, next child
+		for(int r : rootOrder) {
+			stk.push_back({r, succBeg[r]});
+			while(!stk.empty()) {
+				int v = stk.back().first;
+				int &k = stk.back().second;
+				if(k < succBeg[v + 1]) {
+					int c = children[k++];
+					if(post[l][c] < 0 && lo[l][c] == INT_MAX) {
+						lo[l][c] = INT_MAX - 1; //on the stack
+						stk.push_back({c, succBeg[c]});
+					}
+					continue;
+				}
+				int low = counter;
+				for(int j = succBeg[v]; j < succBeg[v + 1]; j++) {
+					low = min(low, lo[l][succList[j]]);
+				}
+				post[l][v] = counter++;
+				lo[l][v] = low;
+				stk.pop_back();
+			}
+		}
+	}
+	seen.assign(numVertices, 0);
+}
+
+//the labels of v nest in those of u in every traversal, necessary for u to reach v
+bool ReachIndex::labelsNest(int u, int v) const {
+	for(int l = 0; l < nLabels; l++) {
+		if(lo[l][v] < lo[l][u] || post[l][v] > post[l][u]) return false;
+	}
+	return true;
+}
+
+bool ReachIndex::reaches(int u, int v) {
+	if(u == v) return true;
+	if(W > 0) return testBit(&closure[(size_t)u * W], v);
+	if(topoRank[u] > topoRank[v] || !labelsNest(u, v)) return false;
+
+	//DFS from u through vertices that can still reach v
+	stamp++;
+	vector<int> stk = {u};
+	seen[u] = stamp;
+	while(!stk.empty()) {
+		int x = stk.back();
+		stk.pop_back();
+		for(int k = succBeg[x]; k < succBeg[x + 1]; k++) {
+			int s = succList[k];
+			if(s == v) return true;
+			if(seen[s] == stamp || topoRank[s] > topoRank[v] || !labelsNest(s, v)) continue;
+			seen[s] = stamp;
+			stk.push_back(s);
+		}
+	}
+	return false;
+}
@@ -0,0 +1,146 @@
+#include "RollingHorizon.h"
+
+RollingHorizon::RollingHorizon(DAG &grph, int winlevels, int ovlap) {
+	gp = grph;
+	winLevels = max(1, winlevels);
+	overlap = max(0, ovlap);
+	numVertices = gp.getNumNodes();
+	succs.resize(numVertices);
+	preds.resize(numVertices);
+	for(list<Edge>::iterator it = gp.edgeBegin(); it != gp.edgeEnd(); it++) {
+		succs[it->getSrcNodeID()].push_back(it->getDestNodeID());
+		preds[it->getDestNodeID()].push_back(it->getSrcNodeID());
+	}
+	for(int v = 0; v < numVertices; v++) {
+		sort(succs[v].begin(), succs[v].end());
+		succs[v].erase(unique(succs[v].begin(), succs[v].end()), succs[v].end());
+		sort(preds[v].begin(), preds[v].end());
+		preds[v].erase(unique(preds[v].begin(), preds[v].end()), preds[v].end());
+	}
+
+	//ASAP levels in Kahn order
+	level.assign(numVertices, 0);
+	vector<int> indeg(numVertices), queue;
+	for(int v = 0; v < numVertices; v++) {
+		indeg[v] = preds[v].size();
+		if(indeg[v] == 0) queue.push_back(v);
+	}
+	for(int h = 0; h < (int)queue.size(); h++) {
+		int v = queue[h];
+		for(int s : succs[v]) {
+			level[s] = max(level[s], level[v] + 1);
+			if(--indeg[s] == 0) queue.push_back(s);
+		}
+	}
+}
+
+//window graph over verts with ids 0..n-1; frozen holds the global partition of frozen vertices, -1 otherwise
+void RollingHorizon::buildWindow(const vector<int> &verts, const vector<int> &frozen, SubProblem &sp) {
+	sp = SubProblem();
+	sp.origIds = verts;
+	sp.numReal = verts.size();
+	unordered_map<int, int> loc;
+	for(int i = 0; i < (int)verts.size(); i++) {
+		loc[verts[i]] = i;
+		sp.graph.addNode(i, gp.findNode(verts[i])->getLabel());
+	}
+
+	int edgeId = 0;
+	map<int, int> inVals; //frozen producer -> boundary value index
+	for(int i = 0; i < (int)verts.size(); i++) {
+		int v = verts[i];
+		bool leaves = false;
+		for(int s : succs[v]) {
+			if(loc.find(s) != loc.end()) {
+				sp.graph.addEdge(edgeId++, i, loc[s], "1:1");
+			}
+			else {
+				leaves = true; //consumed by a vertex beyond the window
+			}
+		}
+		if(leaves) {
+			sp.bndWrites.push_back(i);
+		}
+		for(int q : preds[v]) {
+			if(frozen[q] == -1) continue; //unfrozen preds are inside the window
+			if(inVals.find(q) == inVals.end()) {
+				inVals[q] = sp.bndReads.size();
+				sp.bndReads.push_back(vector<int>());
+			}
+			sp.bndReads[inVals[q]].push_back(i);
+		}
+	}
+}
+
+int RollingHorizon::solve(SubSolver solver, vector<int> &part) {
+	vector<int> frozen(numVertices, -1);
+	int nFrozen = 0;
+	int nextPart = 0;
+	int nWindows = 0;
+	int prevReads = 0; //values read by the last frozen partition
+	while(nFrozen < numVertices) {
+		//window: unfrozen vertices of the next winLevels levels, closed under unfrozen predecessors
+		int front = INT_MAX;
+		for(int v = 0; v < numVertices; v++) {
+			if(frozen[v] == -1) front = min(front, level[v]);
+		}
+		vector<int> verts;
+		bool last = true;
+		for(int v = 0; v < numVertices; v++) {
+			if(frozen[v] != -1) continue;
+			if(level[v] < front + winLevels) verts.push_back(v);
+			else last = false;
+		}
+
+		SubProblem sp;
+		buildWindow(verts, frozen, sp);
+		sp.prevReads = prevReads;
+		sp.label = "window" + to_string(nWindows);
+		sp.graph.setName(gp.getName() + "_" + sp.label);
+		if(!solver(sp)) {
+			cout << "Window " << nWindows << " at level " << front << " could not be solved" << endl;
+			return -1;
+		}
+		nWindows++;
+
+		//freeze the leading partitions, at least one non empty one so the horizon moves
+		vector<int> psize(sp.numParts, 0);
+		for(int i = 0; i < sp.numReal; i++) psize[sp.part[i]]++;
+		int nFreeze = last ? sp.numParts : max(1, sp.numParts - overlap);
+		int used = 0;
+		for(int q = 0; q < nFreeze; q++) used += psize[q] > 0;
+		while(used == 0 && nFreeze < sp.numParts) {
+			used += psize[nFreeze++] > 0;
+		}
+
+		//renumber the frozen non empty partitions after the ones frozen before, pipelined the empty
+		//ones too since the loads of each partition were budgeted in the one before it
+		vector<int> glob(sp.numParts, -1);
+		int keep = nFreeze; //trailing empty partitions of the last window prefetch nothing
+		while(last && keep > 0 && psize[keep - 1] == 0) keep--;
+		for(int q = 0; q < keep; q++) {
+			if(psize[q] > 0 || pipelined) glob[q] = nextPart++;
+		}
+		vector<int> lastFrozen; //vertices of the last frozen partition
+		for(int i = 0; i < sp.numReal; i++) {
+			int q = sp.part[i];
+			if(q < nFreeze) {
+				frozen[verts[i]] = glob[q];
+				nFrozen++;
+				if(glob[q] == nextPart - 1) lastFrozen.push_back(verts[i]);
+			}
+		}
+		set<int> readVals;
+		for(int v : lastFrozen) {
+			for(int u : preds[v]) {
+				if(frozen[u] < nextPart - 1) readVals.insert(u);
+			}
+		}
+		prevReads = readVals.size();
+		cout << "Window " << nWindows << " levels " << front << "-" << front + winLevels - 1 << " vertices " << verts.size()
+			<< " partitions " << sp.numParts << " froze " << used << endl;
+	}
+
+	part = frozen;
+	return nextPart;
+}
@@ -0,0 +1,103 @@
+#include "ScratchPad.h"
+
+ScratchPad::ScratchPad(DAG &gp) {
+	numVertices = gp.getNumNodes();
+	vector<vector<int>> succs(numVertices);
+	for(list<Edge>::iterator it = gp.edgeBegin(); it != gp.edgeEnd(); it++) {
+		succs[it->getSrcNodeID()].push_back(it->getDestNodeID());
+	}
+	succBeg.push_back(0);
+	for(auto &sv : succs) {
+		sort(sv.begin(), sv.end());
+		sv.erase(unique(sv.begin(), sv.end()), sv.end());
+		succList.insert(succList.end(), sv.begin(), sv.end());
+		succBeg.push_back(succList.size());
+	}
+}
+
+int ScratchPad::parseCapacity(const string &arg) {
+	char *end;
+	long cap = strtol(arg.c_str(), &end, 10);
+	if(arg.empty() || *end || cap < 0) {
+		throw string("Bad scratchpad capacity ") + arg;
+	}
+	return (int)min(cap, (long)INT_MAX);
+}
+
+vector<padValue> ScratchPad::liveness(const vector<int> &part, int numParts) const {
+	vector<padValue> vals;
+	for(int v = 0; v < numVertices; v++) {
+		int last = part[v];
+		for(int s = succBeg[v]; s < succBeg[v + 1]; s++) {
+			last = max(last, part[succList[s]]);
+		}
+		if(last > part[v]) vals.push_back(padValue{v, part[v] + 1, last, -1});
+	}
+	stable_sort(vals.begin(), vals.end(), [](const padValue &a, const padValue &b) {return a.from < b.from;});
+
+	//left edge: a value takes the lowest slot whose previous value was last read before it was written
+	priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> busy; //to, slot
+	priority_queue<int, vector<int>, greater<int>> freed;
+	int slots = 0;
+	for(auto &pv : vals) {
+		while(!busy.empty() && busy.top().first < pv.from) {
+			freed.push(busy.top().second);
+			busy.pop();
+		}
+		if(freed.empty()) {
+			pv.slot = slots++;
+		}
+		else {
+			pv.slot = freed.top();
+			freed.pop();
+		}
+		busy.push({pv.to, pv.slot});
+	}
+	return vals;
+}
+
+vector<int> ScratchPad::occupancy(const vector<padValue> &vals, int numParts) {
+	vector<int> occ(numParts + 1, 0);
+	for(auto &pv : vals) {
+		occ[pv.from]++;
+		occ[pv.to + 1]--;
+	}
+	for(int p = 1; p <= numParts; p++) {
+		occ[p] += occ[p - 1];
+	}
+	occ.pop_back();
+	return occ;
+}
+
+int ScratchPad::slotsUsed(const vector<padValue> &vals) {
+	int slots = 0;
+	for(auto &pv : vals) {
+		slots = max(slots, pv.slot + 1);
+	}
+	return slots;
+}
+
+void ScratchPad::printLiveness(const vector<padValue> &vals, int numParts, bool listValues) {
+	vector<int> occ = occupancy(vals, numParts);
+	vector<int> written(numParts, 0);
+	long lifetimes = 0;
+	int longest = 0;
+	for(auto &pv : vals) {
+		written[pv.from]++;
+		lifetimes += pv.to - pv.from + 1;
+		longest = max(longest, pv.to - pv.from + 1);
+	}
+	for(int p = 1; p < numParts; p++) {
+		cout << "Boundary " << p - 1 << "|" << p << " live " << occ[p] << " new " << written[p];
+		if(listValues) {
+			cout << ":";
+			for(auto &pv : vals) {
+				if(pv.from <= p && pv.to >= p) cout << " " << pv.vertex << "@" << pv.slot;
+			}
+		}
+		cout << endl;
+	}
+	int peak = occ.empty() ? 0 : *max_element(occ.begin(), occ.end());
+	cout << "Scratchpad peak " << peak << " values in " << slotsUsed(vals) << " slots, " << vals.size() << " values live "
+		<< (vals.empty() ? 0.0 : double(lifetimes) / vals.size()) << " partitions on average, longest " << longest << endl;
+}
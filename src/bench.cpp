@@ -0,0 +1,253 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <functional>
+#include "Graph.h"
+#include "DFGAnaly.h"
+#include "DFGPart.h"
+#include "DFGUtils.h"
+#include "PartModel.h"
+#include "PartBnB.h"
+#include <bits/stdc++.h>
+
+using namespace std;
+
+//timings of one stage on one graph
+typedef struct BenchRecord {
+	string graph;
+	string stage;
+	int vertices = 0;
+	int edges = 0;
+	int RSize = 0, TSize = 0, loadWeight = 0; //-R, -T and -L of the run
+	int reps = 0;
+	double median = 0, p10 = 0, p90 = 0, minMs = 0; //milliseconds
+} BenchRecord;
+
+static double percentile(const vector<double> &sorted, double p) {
+	int idx = (int)ceil(p / 100.0 * sorted.size()) - 1;
+	return sorted[max(0, min(idx, (int)sorted.size() - 1))];
+}
+
+//warmup untimed runs, then reps timed ones; stage output is discarded. Returns false if the stage
+//throws, which the corpus graphs with group-less load labels do for the model based stages
+static bool timeStage(function<void()> stage, int warmup, int reps, BenchRecord &rec) {
+	ofstream nul("/dev/null");
+	streambuf *old = cout.rdbuf(nul.rdbuf());
+	vector<double> ms;
+	bool ok = true;
+	try {
+		for(int r = 0; r < warmup; r++) {
+			stage();
+		}
+		for(int r = 0; r < reps; r++) {
+			auto start = chrono::steady_clock::now();
+			stage();
+			ms.push_back(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count() / 1e6);
+		}
+	} catch(...) {
+		ok = false;
+	}
+	cout.rdbuf(old);
+	if(!ok) return false;
+	sort(ms.begin(), ms.end());
+	rec.reps = reps;
+	rec.median = percentile(ms, 50);
+	rec.p10 = percentile(ms, 10);
+	rec.p90 = percentile(ms, 90);
+	rec.minMs = ms[0];
+	return true;
+}
+
+//value of "key": in a line written by writeJSON
+static string jsonField(const string &line, const string &key) {
+	size_t pos = line.find("\"" + key + "\":");
+	if(pos == string::npos) return "";
+	pos += key.size() + 3;
+	if(line[pos] == '"') {
+		size_t end = line.find('"', pos + 1);
+		return line.substr(pos + 1, end - pos - 1);
+	}
+	size_t end = line.find_first_of(",}", pos);
+	return line.substr(pos, end - pos);
+}
+
+static void writeJSON(const string &fname, const vector<BenchRecord> &recs) {
+	ofstream out(fname);
+	out << "{\"bench\": [" << endl;
+	for(size_t r = 0; r < recs.size(); r++) {
+		const BenchRecord &b = recs[r];
+		out << "{\"graph\":\"" << b.graph << "\",\"stage\":\"" << b.stage << "\",\"vertices\":" << b.vertices << ",\"edges\":" << b.edges
+			<< ",\"R\":" << b.RSize << ",\"T\":" << b.TSize << ",\"L\":" << b.loadWeight
+			<< ",\"reps\":" << b.reps << ",\"median_ms\":" << b.median << ",\"p10_ms\":" << b.p10 << ",\"p90_ms\":" << b.p90
+			<< ",\"min_ms\":" << b.minMs << "}" << (r + 1 < recs.size() ? "," : "") << endl;
+	}
+	out << "]}" << endl;
+}
+
+//baseline median of one graph and stage with the parameters it was measured under
+typedef struct BaseEntry {
+	string params; //see runParams, "" for files written before the parameters were recorded
+	double median = 0;
+} BaseEntry;
+
+//-R, -T, -L and -reps of a run, medians are only compared between runs with the same ones
+static string runParams(int size, int trans_limit, int loadWt, int reps) {
+	return "R " + to_string(size) + " T " + to_string(trans_limit) + " L " + to_string(loadWt) + " reps " + to_string(reps);
+}
+
+//graph and stage -> entry of a file written by writeJSON
+static map<pair<string, string>, BaseEntry> readBaseline(const string &fname) {
+	map<pair<string, string>, BaseEntry> base;
+	ifstream in(fname);
+	string line;
+	while(getline(in, line)) {
+		string med = jsonField(line, "median_ms");
+		if(med == "") continue;
+		BaseEntry &be = base[{jsonField(line, "graph"), jsonField(line, "stage")}];
+		be.median = atof(med.c_str());
+		string R = jsonField(line, "R"), T = jsonField(line, "T"), L = jsonField(line, "L"), reps = jsonField(line, "reps");
+		if(R != "" && T != "" && L != "" && reps != "") {
+			be.params = runParams(atoi(R.c_str()), atoi(T.c_str()), atoi(L.c_str()), atoi(reps.c_str()));
+		}
+	}
+	return base;
+}
+
+/*benchmark of the partitioning stages over a DFG corpus: dot parse, levelization (DFGAnaly),
+  level partitioning (DFGPart), ILP model construction (PartModel) and heuristic partitioning
+  (single threaded branch and bound cut off after a fixed number of nodes)
+  args: <dot files|dirs|lists>... [-R size] [-T trans limit] [-L load weight]
+        [-warmup n] [-reps n] [-out json] [-baseline json] [-tol percent]
+  with a baseline, stages whose median moved by more than tol percent are marked and the
+  exit status is 1 if any got slower; baseline entries measured with other -R, -T, -L or
+  -reps are not compared*/
+int main(int argc, char **argv) {
+	vector<string> files;
+	int size = 16, trans_limit = 8, loadWt = 1;
+	int warmup = 1, reps = 5;
+	double tol = 10;
+	string outName, baseName;
+	for(int a = 1; a < argc; a++) {
+		string opt = argv[a];
+		bool hasVal = a + 1 < argc;
+		if(opt == "-R" && hasVal) size = atoi(argv[++a]);
+		else if(opt == "-T" && hasVal) trans_limit = atoi(argv[++a]);
+		else if(opt == "-L" && hasVal) loadWt = atoi(argv[++a]);
+		else if(opt == "-warmup" && hasVal) warmup = atoi(argv[++a]);
+		else if(opt == "-reps" && hasVal) reps = max(1, atoi(argv[++a]));
+		else if(opt == "-out" && hasVal) outName = argv[++a];
+		else if(opt == "-baseline" && hasVal) baseName = argv[++a];
+		else if(opt == "-tol" && hasVal) tol = atof(argv[++a]);
+		else if(opt[0] == '-') {
+			cout << "Unknown option " << opt << endl;
+			return -1;
+		}
+		else collectDotFiles(opt, files);
+	}
+	if(files.empty()) {
+		cout << "Usage: <dot files|dirs|lists>... [-R size] [-T trans] [-L loadwt] [-warmup n] [-reps n] [-out json] [-baseline json] [-tol pct]" << endl;
+		return -1;
+	}
+
+	map<pair<string, string>, BaseEntry> base;
+	if(baseName != "") {
+		base = readBaseline(baseName);
+	}
+	string params = runParams(size, trans_limit, loadWt, reps);
+
+	int nameW = 8;
+	for(auto &f : files) nameW = max(nameW, (int)f.size() + 2);
+
+	vector<BenchRecord> recs;
+	int slower = 0, faster = 0, otherParams = 0;
+	cout << std::fixed << std::setprecision(3);
+	cout << left << setw(nameW) << "graph" << setw(10) << "stage" << right << setw(8) << "V" << setw(8) << "E"
+		<< setw(12) << "median_ms" << setw(12) << "p10_ms" << setw(12) << "p90_ms" << (base.empty() ? "" : "  vs baseline") << endl;
+	for(auto &fname : files) {
+		DAG gp;
+		try {
+			gp = DAG(fname);
+		} catch(...) {
+			cout << "Skipping " << fname << ": cannot be parsed" << endl;
+			continue;
+		}
+		int nParts = ceil(float(gp.getNumNodes()) / float(size));
+		partLimits lim;
+		lim.RSize = size;
+		lim.TSize = trans_limit;
+		lim.loadWeight = loadWt;
+
+		vector<pair<string, function<void()>>> stages = {
+			{"parse", [&] {DAG g(fname);}},
+			{"levelize", [&] {DFGAnaly(gp).criticalPathLen();}},
+			{"dfgpart", [&] {DFGPart(gp).partitionDFGVar(size);}},
+			{"model", [&] {
+				PartModel pm(gp, nParts, lim);
+				pm.addColVars();
+				pm.addUniqueCons();
+				pm.addSizeCons();
+				pm.addEdgePrec();
+				pm.addInterPartCons();
+				pm.addLoadStoreReuse();
+				pm.addTransCons();
+				pm.addScratchCons();
+			}},
+			{"heuristic", [&] {
+				PartBnB bnb(gp, lim);
+				bnb.setThreads(1);
+				bnb.setNodeLimit(20000);
+				vector<int> part;
+				for(int p = nParts; p < nParts + 10 && !bnb.solve(p, part); p++);
+			}}
+		};
+
+		for(auto &st : stages) {
+			BenchRecord rec;
+			rec.graph = fname;
+			rec.stage = st.first;
+			rec.vertices = gp.getNumNodes();
+			rec.edges = gp.getNumEdges();
+			rec.RSize = size;
+			rec.TSize = trans_limit;
+			rec.loadWeight = loadWt;
+			cout << left << setw(nameW) << fname << setw(10) << st.first << right << setw(8) << rec.vertices << setw(8) << rec.edges;
+			if(!timeStage(st.second, warmup, reps, rec)) {
+				cout << "  failed" << endl;
+				continue;
+			}
+			recs.push_back(rec);
+			cout << setw(12) << rec.median << setw(12) << rec.p10 << setw(12) << rec.p90;
+			auto it = base.find({fname, st.first});
+			if(it != base.end() && it->second.params != params) {
+				cout << "  other parameters";
+				otherParams++;
+			}
+			else if(it != base.end() && it->second.median > 0) {
+				double change = 100.0 * (rec.median - it->second.median) / it->second.median;
+				cout << "  " << showpos << setprecision(1) << change << "%" << noshowpos << setprecision(3);
+				if(change > tol) {
+					cout << " slower";
+					slower++;
+				}
+				else if(change < -tol) {
+					cout << " faster";
+					faster++;
+				}
+			}
+			cout << endl;
+		}
+	}
+
+	if(outName != "") {
+		writeJSON(outName, recs);
+		cout << "Results written to " << outName << endl;
+	}
+	if(!base.empty()) {
+		cout << "Against baseline " << baseName << ": " << slower << " slower, " << faster << " faster beyond " << setprecision(1) << tol << "%";
+		if(otherParams > 0) {
+			cout << ", " << otherParams << " not compared, measured with other than " << params;
+		}
+		cout << endl;
+	}
+	return slower > 0 ? 1 : 0;
+}
@@ -0,0 +1,204 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include "Graph.h"
+#include "PartEval.h"
+#include "PartBnB.h"
+#include "PartEmit.h"
+#include "PartResult.h"
+#include "ScratchPad.h"
+#include "PerfModel.h"
+#include "PerfTrace.h"
+#include <bits/stdc++.h>
+
+using namespace std;
+
+/*args required: dotfilename, size of partition, transaction limit, load weight
+  optional: -threads <n> worker threads (0 = one per core, default)
+            -time <secs> time limit for each partition count tried (0 = none, default)
+            -perf <spec> estimate the execution time, spec as parsePerfParams (fus defaults to
+                         the partition size)
+            -bytime <counts> solve <counts> partition counts from the first that works and keep the
+                         one with the lowest estimated time, see PerfModel; each count is still
+                         solved for the fewest transactions, the estimate only picks the count
+            -fu <file> FU classes and their capacities, see FUClasses
+            -spad <slots> values the scratchpad holds while a partition runs, see ScratchPad
+            -pipeline double buffered execution: budget each partition for the loads of the next
+                      one and estimate the overlapped time, see PartEval and PerfModel
+            -latency <file> opcode latencies for the estimates, see DFGAnaly*/
+int main(int argc, char **argv) {
+	if(argc < 5) {
+		cout << "Too few arguments, 4 expected" << endl;
+		return -1;
+	}
+	DAG gp;
+
+	char *inpName = argv[1];
+	PerfTrace::setContext(inpName);
+	try {
+		PERF_SCOPE("dot_load");
+		gp = DAG(inpName);
+		gp.setName(inpName);
+	} catch(string ex) {
+		cout << ex << endl;
+	}
+
+	int size = atoi(argv[2]);
+	int trans_limit = atoi(argv[3]);
+	int loadWt = atoi(argv[4]);
+	int threads = 0;
+	double timeLimit = 0;
+	string perfSpec;
+	int timeCounts = 0; //partition counts compared by estimated time, 0 to keep the first that works
+	partLimits lim; //FU classes, scratchpad and pipelining from the options
+	lim.RSize = size;
+	lim.TSize = trans_limit;
+	lim.loadWeight = loadWt;
+	LatencyTable latTable;
+	for(int a = 5; a < argc; a++) {
+		string opt = argv[a];
+		if(opt == "-threads" && a + 1 < argc) {
+			threads = atoi(argv[++a]);
+		}
+		else if(opt == "-time" && a + 1 < argc) {
+			timeLimit = atof(argv[++a]);
+		}
+		else if(opt == "-perf" && a + 1 < argc) {
+			perfSpec = argv[++a];
+		}
+		else if(opt == "-fu" && a + 1 < argc) {
+			try {
+				if(!lim.fu.load(argv[++a])) {
+					cout << "Cannot read FU classes " << argv[a] << endl;
+					return -1;
+				}
+			} catch(string ex) {
+				cout << ex << endl;
+				return -1;
+			}
+		}
+		else if(opt == "-spad" && a + 1 < argc) {
+			try {
+				lim.spSize = ScratchPad::parseCapacity(argv[++a]);
+			} catch(string ex) {
+				cout << ex << endl;
+				return -1;
+			}
+		}
+		else if(opt == "-latency" && a + 1 < argc) {
+			try {
+				if(!DFGAnaly::readLatencyTable(argv[++a], latTable)) {
+					cout << "Cannot read latency table " << argv[a] << endl;
+					return -1;
+				}
+			} catch(string ex) {
+				cout << ex << endl;
+				return -1;
+			}
+		}
+		else if(opt == "-pipeline") {
+			lim.pipelined = true;
+		}
+		else if(opt == "-bytime" && a + 1 < argc) {
+			timeCounts = atoi(argv[++a]);
+			if(timeCounts < 1) {
+				cout << "Bad partition count for -bytime: " << argv[a] << endl;
+				return -1;
+			}
+		}
+		else {
+			cout << "Unknown option " << opt << endl;
+			return -1;
+		}
+	}
+
+	std::cout << std::fixed << std::setprecision(2); //set precision to 2 decimal places
+	auto start = chrono::high_resolution_clock::now();
+
+	PartBnB bnb(gp, lim);
+	bnb.setThreads(threads);
+	bnb.setTimeLimit(timeLimit);
+	PartEval eval(gp, lim);
+	PerfModel *perf = NULL;
+	if(timeCounts > 0 || perfSpec != "") {
+		perfParams base;
+		base.cgra.fus = size;
+		base.pipelined = lim.pipelined;
+		base.latencies = latTable;
+		try {
+			perf = new PerfModel(gp, parsePerfParams(perfSpec, base));
+		} catch(string ex) {
+			cout << ex << endl;
+			return -1;
+		}
+	}
+
+	vector<int> part;
+	int numParts = ceil(float(gp.getNumNodes()) / float(size)); //start from total vertices divided by partition size
+	int iterations = 100;
+	int bestParts = -1, bestIter = 0, firstParts = -1;
+	bool bestOptimal = false;
+	double bestTime = 0;
+	for(int i = 1; i <= iterations; i++, numParts++) {
+		vector<int> cand;
+		bool found;
+		{
+			PERF_SCOPE("solve");
+			found = bnb.solve(numParts, cand);
+		}
+		PerfTrace::counter("bnb_nodes", bnb.getNodes());
+		if(!found) {
+			if(!bnb.isOptimal()) {
+				cout << "No solution with partitions " << numParts << " within the time limit" << endl;
+			}
+			continue;
+		}
+		double time = 0;
+		if(timeCounts > 0) {
+			time = perf->estimate(cand, numParts).batchCycles;
+			cout << "Partitions " << numParts << " estimated " << time << " cycles per invocation" << endl;
+		}
+		if(bestParts < 0 || time < bestTime) {
+			part = cand;
+			bestParts = numParts;
+			bestIter = i;
+			bestOptimal = bnb.isOptimal();
+			bestTime = time;
+		}
+		if(firstParts < 0) firstParts = numParts;
+		if(numParts >= firstParts + timeCounts - 1) break;
+	}
+	if(bestParts < 0) {
+		cout << "No solution found" << endl;
+		return -1;
+	}
+	numParts = bestParts;
+
+	{
+		vector<partCounts> counts;
+		string err;
+		{
+			PERF_SCOPE("validate");
+			err = eval.validate(part, numParts, counts);
+		}
+		if(err != "") {
+			cout << "Invalid solution: " << err << endl;
+			return -1;
+		}
+		eval.printCounts(counts);
+		ScratchPad::printLiveness(ScratchPad(gp).liveness(part, numParts), numParts);
+		if(perf != NULL) {
+			perf->printEstimate(perf->estimate(part, numParts));
+		}
+		string dir = partsDir(gp.getName(), size, trans_limit, loadWt);
+		PERF_SCOPE("save");
+		PartEmitter(gp).emit(part, numParts, dir);
+		writePartResult(dir + "assign.part", makeResult(gp, part, numParts, lim));
+		auto stop = chrono::high_resolution_clock::now();
+		double secs = chrono::duration_cast<chrono::milliseconds>(stop - start).count() / 1000.0;
+		cout << "Solution stats " << secs << " " << numParts << " " << bestIter << " " << eval.cost(counts) << endl;
+		cout << "Solution found in iteration number " << bestIter << " with partitions " << numParts << (bestOptimal ? " (optimal)" : " (time limit)") << endl;
+	}
+	delete perf;
+	return 0;
+}
@@ -0,0 +1,293 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <functional>
+#include "Graph.h"
+#include "GraphUtils.h"
+#include "DFGTransform.h"
+#include "DFGCoarsen.h"
+#include "DFGPart.h"
+#include "PartBnB.h"
+#include "PartEval.h"
+#include "PartEmit.h"
+#include "PartResult.h"
+#include "PartSched.h"
+#include "ScratchPad.h"
+#include "PerfModel.h"
+#include "PerfTrace.h"
+#include <bits/stdc++.h>
+
+using namespace std;
+
+//one pass of the command line with its arguments
+typedef struct Pass {
+	string name;
+	vector<string> args;
+} Pass;
+
+static const char *usage = "Usage: <in.dot> [-convert] [-fu file] [-spad n] [-pipeline] [-latency file] [-loadsan] [-normalize] [-dce] [-renumber o] [-coarsen w] [-partition bnb R T L [threads] | level R] [-schedule F P] [-liveness] [-estimate spec] [-o out.dot]";
+
+//true if arg is a whole number from lo to INT_MAX, so the passes can take it with stoi
+static bool isCount(const string &arg, long lo) {
+	char *end;
+	long v = strtol(arg.c_str(), &end, 10);
+	return !arg.empty() && *end == '\0' && v >= lo && v <= INT_MAX;
+}
+
+//run a pass, report its time and the graph it left
+static void timed(const string &name, DAG &gp, function<void()> body) {
+	auto start = chrono::steady_clock::now();
+	{
+		PERF_SCOPE(name.c_str());
+		body();
+	}
+	double ms = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count() / 1000.0;
+	cout << left << setw(12) << name << right << " V " << setw(8) << gp.getNumNodes() << " E " << setw(8) << gp.getNumEdges()
+		<< " " << setw(10) << ms << " ms" << endl;
+}
+
+//partition gp under lim, through its coarsened graph if coarseWt > 0; returns the partition count, -1 if none
+static int partition(DAG &gp, const Pass &ps, int coarseWt, const partLimits &lim, const LatencyTable &latTable, vector<int> &part) {
+	string engine = ps.args[0];
+	int size = lim.RSize;
+	if(engine == "level") {
+		DFGPart dfgP(gp, lim, latTable);
+		int numParts = dfgP.partitionDFGVar(size);
+		part = dfgP.getAssign();
+		return numParts > 0 ? numParts : -1;
+	}
+
+	DFGCoarsen *cr = NULL;
+	DAG *pg = &gp;
+	if(coarseWt > 0) {
+		cr = new DFGCoarsen(gp, min(coarseWt, size));
+		cr->coarsen();
+		pg = &cr->getCoarseGraph();
+		cout << "Coarsened to " << pg->getNumNodes() << " vertices" << endl;
+	}
+	PartBnB bnb(*pg, lim);
+	bnb.setThreads(ps.args.size() > 4 ? stoi(ps.args[4]) : 0);
+	if(cr != NULL) {
+		bnb.setWeights(cr->getWeights());
+		bnb.setClassUsage(lim.fu.usage(*cr));
+	}
+	int numParts = ceil(float(gp.getNumNodes()) / float(size));
+	int found = -1;
+	for(int i = 1; i <= 100 && found < 0; i++, numParts++) {
+		if(bnb.solve(numParts, part)) {
+			found = numParts;
+		}
+	}
+	if(found > 0 && cr != NULL) {
+		part = cr->expand(part);
+	}
+	delete cr;
+	return found;
+}
+
+/*in-memory preprocessing and partitioning of one DFG, the passes run in the order given on
+  one graph and only the input and the results touch the disk
+  args: <in.dot> [-convert] [-fu <file>] [-spad <slots>] [-pipeline] [-latency <file>] passes... [-o out.dot]
+  -convert                 the input is a raw exported DOT file (what dotconv1 reads)
+  -fu <file>               FU classes and their capacities for the partitioners, see FUClasses
+  -spad <slots>            values the scratchpad holds while a partition runs, see ScratchPad
+  -pipeline                double buffered execution for bnb partitioning and -estimate, see PartEval
+  -latency <file>          opcode latencies for level partitioning, -schedule and -estimate, see DFGAnaly
+  passes: -loadsan         drop load address computations (ConvLoadSan)
+          -normalize       renumber ids 0..V-1 (Normalize)
+          -dce             drop nodes whose value reaches no store
+          -renumber <o>    renumber for locality, o is bfs, level or rcm (see renumber); the passes
+                           after it work on the new ids but report and save partitions in the ids
+                           before it, and -o writes the input id of every vertex to out.dot.ids
+          -coarsen <w>     let the following bnb partitioning work on clusters of up to w vertices
+          -partition bnb <size> <trans limit> <load weight> [threads]
+          -partition level <map size>
+                           partition and write outputParts/<name>_R_T_L/ with assign.part; bnb
+                           keeps the first partition count that works, there is no time
+                           objective as in bnb -bytime or main -objective time
+          -schedule <fus> <ports>
+                           list schedule the partitions of the last -partition, see PartSched
+          -liveness        scratchpad values live at every boundary of the last -partition with
+                           their buffer slots, see ScratchPad
+          -estimate <spec> execution time of the last -partition, spec as parsePerfParams, see PerfModel
+  -o out.dot               write the graph left by the graph passes*/
+int main(int argc, char **argv) {
+	if(argc < 2) {
+		cout << usage << endl;
+		return -1;
+	}
+	string inName = argv[1];
+	string outName, fuFile, spArg, latFile;
+	bool convert = false;
+	partLimits limits; //FU classes, scratchpad and pipelining for every -partition
+	vector<Pass> passes;
+	for(int a = 2; a < argc; a++) {
+		string opt = argv[a];
+		int left = argc - a - 1;
+		if(opt == "-convert") convert = true;
+		else if(opt == "-o" && left >= 1) outName = argv[++a];
+		else if(opt == "-fu" && left >= 1) fuFile = argv[++a];
+		else if(opt == "-spad" && left >= 1) spArg = argv[++a];
+		else if(opt == "-pipeline") limits.pipelined = true;
+		else if(opt == "-latency" && left >= 1) latFile = argv[++a];
+		else if(opt == "-loadsan" || opt == "-normalize" || opt == "-dce" || opt == "-liveness") passes.push_back({opt.substr(1), {}});
+		else if(opt == "-coarsen" && left >= 1) passes.push_back({"coarsen", {argv[++a]}});
+		else if(opt == "-renumber" && left >= 1) passes.push_back({"renumber", {argv[++a]}});
+		else if(opt == "-estimate" && left >= 1) passes.push_back({"estimate", {argv[++a]}});
+		else if(opt == "-schedule" && left >= 2) {
+			passes.push_back({"schedule", {argv[a + 1], argv[a + 2]}});
+			a += 2;
+		}
+		else if(opt == "-partition" && left >= 2 && string(argv[a + 1]) == "level") {
+			passes.push_back({"partition", {argv[a + 1], argv[a + 2]}});
+			a += 2;
+		}
+		else if(opt == "-partition" && left >= 4 && string(argv[a + 1]) == "bnb") {
+			Pass ps = {"partition", {argv[a + 1], argv[a + 2], argv[a + 3], argv[a + 4]}};
+			a += 4;
+			if(a + 1 < argc && argv[a + 1][0] != '-') ps.args.push_back(argv[++a]);
+			passes.push_back(ps);
+		}
+		else {
+			cout << "Unknown or incomplete option " << opt << endl;
+			return -1;
+		}
+	}
+	//numeric pass arguments are checked before anything runs
+	for(auto &ps : passes) {
+		vector<long> lo; //lowest value of each argument, -1 for the ones that are not numbers
+		if(ps.name == "coarsen") lo = {1};
+		else if(ps.name == "schedule") lo = {1, 1};
+		else if(ps.name == "partition") lo = {-1, 1, 1, 0, 0}; //engine, R, T, L, threads (0 = one per core)
+		for(size_t i = 0; i < ps.args.size() && i < lo.size(); i++) {
+			if(lo[i] >= 0 && !isCount(ps.args[i], lo[i])) {
+				cout << "Bad number " << ps.args[i] << " for -" << ps.name << endl;
+				cout << usage << endl;
+				return -1;
+			}
+		}
+	}
+
+	std::cout << std::fixed << std::setprecision(3);
+	PerfTrace::setContext(inName);
+	DAG gp;
+	try {
+		if(fuFile != "" && !limits.fu.load(fuFile)) {
+			throw string("Cannot read FU classes ") + fuFile;
+		}
+		limits.spSize = spArg == "" ? INT_MAX : ScratchPad::parseCapacity(spArg);
+		LatencyTable latTable;
+		if(latFile != "" && !DFGAnaly::readLatencyTable(latFile, latTable)) {
+			throw string("Cannot read latency table ") + latFile;
+		}
+		timed(convert ? "convert" : "load", gp, [&] {
+			gp = convert ? convertDOT(inName) : DAG(inName);
+		});
+		gp.setName(inName);
+
+		int coarseWt = 0;
+		//after -renumber passes the partitions are reported and saved for idGraph, the graph before
+		//them; origId[v] is the vertex of idGraph behind vertex v of gp, empty when gp is that graph
+		DAG idGraph;
+		vector<int> origId;
+		vector<int> lastPart; //result of the last partitioning in idGraph ids, for -schedule, -liveness and -estimate
+		int lastParts = -1;
+		for(auto &ps : passes) {
+			if(ps.name != "schedule" && ps.name != "liveness" && ps.name != "estimate" && ps.name != "coarsen") lastParts = -1; //graph passes renumber the vertices
+			if(ps.name == "loadsan" || ps.name == "normalize" || ps.name == "dce") origId.clear(); //their ids are the new reference
+			if(ps.name == "loadsan") timed(ps.name, gp, [&] {gp = loadSanitize(gp);});
+			else if(ps.name == "normalize") timed(ps.name, gp, [&] {gp = normalize(gp);});
+			else if(ps.name == "dce") timed(ps.name, gp, [&] {gp = eliminateDead(gp);});
+			else if(ps.name == "renumber") {
+				bool dense = gp.getNumNodes() == 0 || (int)gp.getMaxNodeID() + 1 == (int)gp.getNumNodes();
+				if(origId.empty() && dense) {
+					idGraph = gp;
+					idGraph.setName(inName);
+				}
+				vector<int> passId;
+				timed(ps.name, gp, [&] {gp = renumber(gp, ps.args[0], passId);});
+				if(!origId.empty()) {
+					for(int &id : passId) id = origId[id]; //compose with the earlier renumberings
+					origId = passId;
+				}
+				else if(dense) {
+					origId = passId;
+				}
+			}
+			else if(ps.name == "coarsen") coarseWt = stoi(ps.args[0]);
+			else if(ps.name == "partition") {
+				gp.setName(inName);
+				partLimits lim = limits;
+				lim.RSize = stoi(ps.args[1]);
+				if(ps.args.size() > 2) { //the level partitioner has no transaction limit
+					lim.TSize = stoi(ps.args[2]);
+					lim.loadWeight = stoi(ps.args[3]);
+				}
+				vector<int> part;
+				int numParts = -1;
+				timed(ps.name, gp, [&] {numParts = partition(gp, ps, coarseWt, lim, latTable, part);});
+				if(numParts < 0) {
+					cout << "No partitioning found" << endl;
+					return -1;
+				}
+				part = restoreOrder(part, origId);
+				DAG &saveGraph = origId.empty() ? gp : idGraph;
+				PartResult res = makeResult(saveGraph, part, numParts, lim);
+				timed("save", gp, [&] {
+					string dir = partsDir(saveGraph.getName(), lim.RSize, ps.args.size() > 2 ? lim.TSize : 0, lim.loadWeight);
+					PartEmitter(saveGraph).emit(part, numParts, dir);
+					writePartResult(dir + "assign.part", res);
+				});
+				cout << "Partitions " << numParts << " cost " << res.cost << endl;
+				lastPart = part;
+				lastParts = numParts;
+			}
+			else if(ps.name == "schedule") {
+				if(lastParts < 0) {
+					cout << "Nothing to schedule, -schedule needs an earlier -partition" << endl;
+					return -1;
+				}
+				PartSched sched(origId.empty() ? gp : idGraph, CGRAConfig{stoi(ps.args[0]), stoi(ps.args[1])}, latTable);
+				vector<partSched> scheds;
+				vector<int> start;
+				timed(ps.name, gp, [&] {scheds = sched.schedule(lastPart, lastParts, start);});
+				sched.printScheds(scheds);
+			}
+			else if(ps.name == "liveness") {
+				if(lastParts < 0) {
+					cout << "No partitioning, -liveness needs an earlier -partition" << endl;
+					return -1;
+				}
+				vector<padValue> vals;
+				timed(ps.name, gp, [&] {vals = ScratchPad(origId.empty() ? gp : idGraph).liveness(lastPart, lastParts);});
+				ScratchPad::printLiveness(vals, lastParts, true);
+			}
+			else if(ps.name == "estimate") {
+				if(lastParts < 0) {
+					cout << "No partitioning, -estimate needs an earlier -partition" << endl;
+					return -1;
+				}
+				perfParams base;
+				base.pipelined = limits.pipelined;
+				base.latencies = latTable;
+				PerfModel perf(origId.empty() ? gp : idGraph, parsePerfParams(ps.args[0], base));
+				perfEstimate est;
+				timed(ps.name, gp, [&] {est = perf.estimate(lastPart, lastParts);});
+				perf.printEstimate(est);
+			}
+		}
+
+		if(outName != "") {
+			timed("write", gp, [&] {toDOT(outName, gp);});
+			if(!origId.empty()) {
+				ofstream ids(outName + ".ids");
+				for(int id : origId) ids << id << "\n";
+				if(!ids) throw string("Cannot write ") + outName + ".ids";
+			}
+		}
+	} catch(string ex) {
+		cout << ex << endl;
+		return -1;
+	}
+	return 0;
+}
@@ -0,0 +1,99 @@
+#include <iostream>
+#include <string>
+#include "Graph.h"
+#include "DFGGen.h"
+#include <bits/stdc++.h>
+
+using namespace std;
+
+static const char *usage = "Usage: -o <out.dot> [-seed s] [-group n] [-layered L W F] [-fft logn] [-stencil W H S] [-reduce n arity] [-matmul m n k] [-replicate dot copies]";
+
+//the count args of a shape, all of them whole numbers above zero
+static bool readCounts(char **argv, int a, int num, int *vals) {
+	for(int i = 0; i < num; i++) {
+		char *end;
+		long v = strtol(argv[a + 1 + i], &end, 10);
+		if(*end != '\0' || end == argv[a + 1 + i] || v < 1 || v > INT_MAX) return false;
+		vals[i] = v;
+	}
+	return true;
+}
+
+/*synthetic DFG generator, every shape given adds a disjoint component to one graph
+  args: -o <out.dot> [-seed s] [-group n] shapes...
+  shapes: -layered <layers> <width> <fanin>   random layered DAG
+          -fft <log2 points>                  radix-2 butterflies
+          -stencil <width> <height> <steps>   5-point stencil sweeps
+          -reduce <n> <arity>                 reduction tree
+          -matmul <m> <n> <k>                 matrix multiply tile
+          -replicate <dot> <copies>           copies of an existing kernel
+  e.g. -o big.dot -seed 7 -layered 200 500 2 -fft 10*/
+int main(int argc, char **argv) {
+	string outName;
+	unsigned seed = 1;
+	int groupSize = 4;
+	//options first so the seed and group size apply to every shape whatever the order
+	for(int a = 1; a < argc; a++) {
+		string opt = argv[a];
+		if(opt == "-o" && a + 1 < argc) outName = argv[++a];
+		else if(opt == "-seed" && a + 1 < argc) seed = strtoul(argv[++a], NULL, 10);
+		else if(opt == "-group" && a + 1 < argc) {
+			if(!readCounts(argv, a++, 1, &groupSize)) {
+				cout << "The group size must be above zero" << endl;
+				cout << usage << endl;
+				return -1;
+			}
+		}
+	}
+	if(outName == "") {
+		cout << usage << endl;
+		return -1;
+	}
+
+	DFGGen gen(seed, groupSize);
+	try {
+		for(int a = 1; a < argc; a++) {
+			string opt = argv[a];
+			int left = argc - a - 1;
+			int n[3];
+			if((opt == "-o" || opt == "-seed" || opt == "-group") && left >= 1) a++;
+			else if(opt == "-layered" && left >= 3 && readCounts(argv, a, 3, n)) {
+				gen.layered(n[0], n[1], n[2]);
+				a += 3;
+			}
+			else if(opt == "-fft" && left >= 1 && readCounts(argv, a, 1, n)) {
+				gen.fft(n[0]);
+				a++;
+			}
+			else if(opt == "-stencil" && left >= 3 && readCounts(argv, a, 3, n)) {
+				gen.stencil(n[0], n[1], n[2]);
+				a += 3;
+			}
+			else if(opt == "-reduce" && left >= 2 && readCounts(argv, a, 2, n)) {
+				gen.reduce(n[0], n[1]);
+				a += 2;
+			}
+			else if(opt == "-matmul" && left >= 3 && readCounts(argv, a, 3, n)) {
+				gen.matmul(n[0], n[1], n[2]);
+				a += 3;
+			}
+			else if(opt == "-replicate" && left >= 2 && readCounts(argv, a + 1, 1, n)) {
+				DAG kernel(argv[a + 1]);
+				gen.replicate(kernel, n[0]);
+				a += 2;
+			}
+			else {
+				cout << "Unknown or incomplete option " << opt << ", sizes and counts must be above zero" << endl;
+				cout << usage << endl;
+				return -1;
+			}
+		}
+		gen.storeSinks();
+		gen.write(outName);
+	} catch(string ex) {
+		cout << ex << endl;
+		return -1;
+	}
+	cout << "Generated " << outName << " with " << gen.getNumNodes() << " vertices and " << gen.getNumEdges() << " edges" << endl;
+	return 0;
+}
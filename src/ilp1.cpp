@@ -3,24 +3,33 @@
 #include "glpk.h"
 #include "Edge.h"
 #include "Graph.h"
+#include "LPModel.h"
+#include "FUClasses.h"
 #include <cmath>
 #include <bits/stdc++.h>
 using namespace std;
 
 class GraphILP {
 	private:
-		glp_prob *lp; //lp object
+		glp_prob *lp = nullptr; //lp object, only created when solving
+		LPModel desc; //model description, written out or loaded into glpk
 		int numEdges, numVertices, numParts;
 		int RSize; //size of partition
 		int TSize;//size of transaction
 		DAG graph;//input graph
+		FUClasses fu; //capacities per FU class on top of RSize
 		vector<map<pair<int, int>, int>> klMapVec;//map of kl values for cross partition edges
 		map<pair<int, int>, int> ijMap; //map of ij values
+		//column indices are 0 based in desc, glpk ones are shifted by one
+		double colVal(int col) {
+			return glp_mip_col_val(lp, col + 1);
+		}
 
 	public:
 
-	GraphILP(string name, DAG gp, int rsize, int tsize) {
+	GraphILP(string name, DAG gp, int rsize, int tsize, const FUClasses &classes = FUClasses()) {
 		this->graph = gp;
+		this->fu = classes;
 		this->RSize = rsize;
 		this->TSize = tsize;
 		this->numVertices = gp.getNumNodes();
@@ -29,16 +38,53 @@ class GraphILP {
 
 		this->numParts = ceil(float(numVertices) / float(RSize)); //set initial partition size to total vertices divided by partition size
 
-		this->lp = glp_create_prob();
-		glp_set_prob_name(this->lp, name.c_str()); //create lp object with name in constructor
+		this->desc = LPModel(name); //create lp description with name in constructor
 	}
 
 	~GraphILP() {
-		glp_delete_prob(lp);
+		if(lp) glp_delete_prob(lp);
 	}
 
 	void eraseProb() {
+		desc.clear();
+		if(lp) glp_erase_prob(lp);
+	}
+
+	//copy the model description into a glpk problem for solving
+	void loadProb() {
+		if(lp == nullptr) {
+			lp = glp_create_prob();
+			glp_set_prob_name(lp, desc.getName().c_str());
+		}
 		glp_erase_prob(lp);
+		int ncols = desc.getNumCols();
+		int nrows = desc.getNumRows();
+		if(ncols) glp_add_cols(lp, ncols);
+		if(nrows) glp_add_rows(lp, nrows);
+		for(int c = 0; c < ncols; c++) {
+			glp_set_obj_coef(lp, c + 1, desc.getObj(c));
+			glp_set_col_bnds(lp, c + 1, GLP_DB, desc.getColLo(c), desc.getColHi(c));
+			if(desc.isBinary(c)) {
+				glp_set_col_kind(lp, c + 1, GLP_BV);
+			}
+		}
+		vector<int> ia(1), ja(1);
+		vector<double> ar(1); //0th element not used
+		for(int r = 0; r < nrows; r++) {
+			double lo = desc.getRowLo(r), hi = desc.getRowHi(r);
+			int type = GLP_DB;
+			if(lo == hi) type = GLP_FX;
+			else if(lo <= -LP_INF && hi >= LP_INF) type = GLP_FR;
+			else if(lo <= -LP_INF) type = GLP_UP;
+			else if(hi >= LP_INF) type = GLP_LO;
+			glp_set_row_bnds(lp, r + 1, type, lo, hi);
+			for(int k = desc.getRowBeg(r); k < desc.getRowEnd(r); k++) {
+				ia.push_back(r + 1);
+				ja.push_back(desc.getInd(k) + 1);
+				ar.push_back(desc.getVal(k));
+			}
+		}
+		glp_load_matrix(lp, ia.size() - 1, ia.data(), ja.data(), ar.data());
 	}
 	//increment number of partitions
 	void incParts() {
@@ -54,15 +100,11 @@ class GraphILP {
 		//add all vertices-parts mapping as cols
 
 		this->ijMap.clear();
-		int cls = glp_add_cols(lp, numVertices * numParts);
+		int cls;
 		int count = 0;
 		for(int i = 0; i < numVertices; i++) {
 			for(int j = 0; j < numParts; j++) {
-				ijMap[{i, j}] = cls;
-				glp_set_obj_coef(lp, cls, 0.0);
-				glp_set_col_bnds(lp, cls, GLP_DB, 0.0, 1.0);
-				glp_set_col_kind(lp, cls, GLP_BV);
-				cls++;
+				ijMap[{i, j}] = desc.addBinCol("x" + to_string(i) + "," + to_string(j), 0.0);
 				count++;
 			} 
 		}
@@ -76,13 +118,11 @@ class GraphILP {
 			map<pair<int, int>, int> klMap;
 			for(int k = 0; k < numParts; k++) {
 				for(int l = k; l < numParts; l++) {
-					cls = glp_add_cols(lp, 1);
+					cls = desc.addBinCol("", 0.0);
 					klMap[{k ,l}] = cls;
 					if(k != l) {// do not add edges in same partition
-						glp_set_obj_coef(lp, cls, 1.0);
+						desc.setObj(cls, 1.0);
 					}
-					glp_set_col_bnds(lp, cls, GLP_DB, 0.0, 1.0);
-					glp_set_col_kind(lp, cls, GLP_BV);
 					count++;
 				}
 			}
@@ -98,39 +138,23 @@ class GraphILP {
 		int nCons = 0;
 		//(l > k) X^kl_ij < T
 		for(int k = 0; k < numParts - 1; k++) {
-			vector<double> arr;
-			vector<int> ja;
-			arr.push_back(0);
-			ja.push_back(0);//0th element not used
+			desc.beginRow("", -LP_INF, TSize); //add one for k's outgoing edges
 			for(int l = k + 1; l < numParts; l++) {
-				for(auto klMap: this->klMapVec) {
-					ja.push_back(klMap[{k, l}]);
-					arr.push_back(1);
+				for(auto &klMap: this->klMapVec) {
+					desc.addCoef(klMap[{k, l}], 1);
 				}
 			}
-
-			int nr = glp_add_rows(lp, 1); //add one for k's outgoing edges
-			glp_set_mat_row(lp, nr, arr.size() - 1, ja.data(), arr.data());
-			glp_set_row_bnds(lp, nr, GLP_UP, 0.0, TSize);
 			nCons++;
 		}
 		
 		//(k < l) X^kl_ij < T
 		for(int l = 1; l < numParts; l++) {
-			vector<double> arr;
-			vector<int> ja;
-			arr.push_back(0);
-			ja.push_back(0);//0th element not used
+			desc.beginRow("", -LP_INF, TSize); //add one for l's incoming edges
 			for(int k = 0; k < l; k++) {
-				for(auto klMap: this->klMapVec) {
-					ja.push_back(klMap[{k, l}]);
-					arr.push_back(1);
+				for(auto &klMap: this->klMapVec) {
+					desc.addCoef(klMap[{k, l}], 1);
 				}
 			}
-
-			int nr = glp_add_rows(lp, 1); //add one for k's outgoing edges
-			glp_set_mat_row(lp, nr, arr.size() - 1, ja.data(), arr.data());
-			glp_set_row_bnds(lp, nr, GLP_UP, 0.0, TSize);
 			nCons++;
 
 		}
@@ -141,26 +165,15 @@ class GraphILP {
 
 	//add uniqueness constraint of mapping n vertices to p partitions
 	void addUniqueCons() {
-		//numVertices * numParts coef matrix for constraints
-		int *ja = new int [1 + numParts];
-		double *arr = new double [1 + numParts];
 		int nCons = 0;
 		
-		int nr = glp_add_rows(lp, numVertices); //numVertices rows constraints
-		
-			//set rows bound sum euqal to 1.0
-		for(int j = 0; j < numVertices; j++) {
-			glp_set_row_bnds(lp, nr + j, GLP_FX, 1.0, 1.0);
-		}
-
 		//set constraints matrix to 1 for a given vertex in all partitions as only vertex needs to get mapped
+		//set rows bound sum euqal to 1.0
 		for(int i = 0; i < numVertices; i++) {
+			desc.beginRow("", 1.0, 1.0);
 			for(int j = 0; j < numParts; j++) {
-				//shift by numParts * row_id + index
-				ja[j + 1] = ijMap[{i, j}];
-				arr[j + 1] = 1.0;
+				desc.addCoef(ijMap[{i, j}], 1.0);
 			}
-			glp_set_mat_row(lp, nr + i, numParts, ja, arr);
 			nCons++;
 		}
 
@@ -174,7 +187,7 @@ class GraphILP {
 		for(uint32_t i = 0; i < this->graph.getNumNodes(); i++) {
 			int count = 0;
 			for(int j = 0; j < numParts; j++) {
-				if(glp_mip_col_val(lp, ijMap[{i, j}]) == 1) {
+				if(colVal(ijMap[{i, j}]) == 1) {
 					count++;
 				}
 			}
@@ -182,26 +195,32 @@ class GraphILP {
 		}
 	}
 	void addSizeCons() {
-		int *ja = new int [1 + numVertices];
-		double *arr = new double [1 + numVertices];
 		int nCons = 0;
 
-		int nr = glp_add_rows(lp, numParts); //numParts rows constraints
-		for(int j = 0; j < numParts; j++) {
-			glp_set_row_bnds(lp, nr + j, GLP_UP, 0.0, RSize);
-		}
-
 		//set constraints to less than Rsize for all vertices of a partition
 		for(int i = 0; i < numParts; i++) {
+			desc.beginRow("", -LP_INF, RSize);
 			for(int j = 0; j < numVertices; j++) {
-				//row + shift by i + partition number id
-				ja[j + 1] = i + j*numParts + 1;
-				arr[j + 1] = 1.0;
+				desc.addCoef(ijMap[{j, i}], 1.0);
 			}
-			glp_set_mat_row(lp, nr + i, numVertices, ja, arr);
 			nCons++;
 		}
 
+		//and to the capacity of each FU class
+		if(fu.limited()) {
+			int nc = fu.numClasses();
+			vector<int> use = fu.usage(graph);
+			for(int c = 0; c < nc; c++) {
+				for(int i = 0; i < numParts; i++) {
+					desc.beginRow("", -LP_INF, fu.getCapacity(c));
+					for(int j = 0; j < numVertices; j++) {
+						if(use[j * nc + c] > 0) desc.addCoef(ijMap[{j, i}], use[j * nc + c]);
+					}
+					nCons++;
+				}
+			}
+		}
+
 		cout << "Total number of capacity/size constraints " << nCons << endl;
 
 
@@ -212,7 +231,7 @@ class GraphILP {
 		for(int i = 0; i < numParts; i++) {
 			int count = 0;
 			for(uint32_t j = 0; j < graph.getNumNodes(); j++) {
-				if(glp_mip_col_val(lp, ijMap[{j, i}]) == 1) {
+				if(colVal(ijMap[{j, i}]) == 1) {
 					count++; //add if vertex present in this partition
 				}
 			}
@@ -223,8 +242,6 @@ class GraphILP {
 
 	void addCommCons() {
 
-		int *ja = new int[1 + 3]; //3 terms in the each equation
-		double *arr = new double[1 + 3]; //3 terms in the each equation
 		int i = 0;
 		for(list<Edge>::iterator it = graph.edgeBegin(); it != graph.edgeEnd(); it++) {
 			uint32_t src = it->getSrcNodeID();
@@ -232,30 +249,19 @@ class GraphILP {
 			
 			for(int k = 0; k < numParts - 1; k++) {
 				for(int l = k + 1; l < numParts; l++) {
-					int nr = glp_add_rows(lp, 2);
-
 					//first equation
-					//Xi_k
-					ja[1] = (src * numParts) + k + 1;
-					//Xj_l
-					ja[2] = (dest * numParts) + l + 1;
-					//Xi_j^k_l
-					ja[3] = this->klMapVec[i][{k ,l}];
-					//ja[3] = (numVertices * numParts) + (i * numParts * numParts) +  (k * numParts) + l + 1;
-					arr[1] = arr[2] = 1.0;
-					arr[3] = -1.0;
-
-					glp_set_mat_row(lp, nr, 3, ja, arr);
-					glp_set_row_bnds(lp, nr, GLP_UP, 0.0, 1.0);
-
+					//Xi_k + Xj_l - Xi_j^k_l <= 1
+					desc.beginRow("", -LP_INF, 1.0);
+					desc.addCoef(ijMap[{src, k}], 1.0);
+					desc.addCoef(ijMap[{dest, l}], 1.0);
+					desc.addCoef(this->klMapVec[i][{k ,l}], -1.0);
 
 					//second equation
 					//format same, coefs different
-					arr[1] = arr[2] = -1.0;
-					arr[3] = 2.0;
-
-					glp_set_mat_row(lp, nr + 1, 3, ja, arr);
-					glp_set_row_bnds(lp, nr + 1, GLP_UP, 0.0, 0.0);
+					desc.beginRow("", -LP_INF, 0.0);
+					desc.addCoef(ijMap[{src, k}], -1.0);
+					desc.addCoef(ijMap[{dest, l}], -1.0);
+					desc.addCoef(this->klMapVec[i][{k ,l}], 2.0);
 
 				}
 
@@ -277,38 +283,22 @@ class GraphILP {
 
 			//first constraint sum (p < l) Xi_j^p_l = Xj_l
 			for(int l = 0; l < numParts; l++) {
-				vector<int> ja;
-				vector<double> arr;
-				ja.push_back(0);
-				arr.push_back(0); //0th not used
+				desc.beginRow("", 0.0, 0.0);
 				for(int p = 0; p <= l; p++) {
-					ja.push_back(klMapVec[i][{p, l}]);
-					arr.push_back(1);
+					desc.addCoef(klMapVec[i][{p, l}], 1);
 				}
-				ja.push_back(ijMap[{dest_j, l}]);
-				arr.push_back(-1);
-				int nr = glp_add_rows(lp, 1);
+				desc.addCoef(ijMap[{dest_j, l}], -1);
 				nCons++;
-				glp_set_mat_row(lp, nr, arr.size() - 1, ja.data(), arr.data());
-				glp_set_row_bnds(lp, nr, GLP_FX, 0.0, 0.0);
 			}
 
 			//second constraint sum (p > k) Xi_j^k_p = Xi_k
 			for(int k = 0; k < numParts; k++) {
-				vector<int> ja;
-				vector<double> arr;
-				ja.push_back(0);
-				arr.push_back(0); //0th not used
+				desc.beginRow("", -LP_INF, 0.0);
 				for(int p = k; p < numParts; p++) {
-					ja.push_back(klMapVec[i][{k, p}]);
-					arr.push_back(1);
+					desc.addCoef(klMapVec[i][{k, p}], 1);
 				}
-				ja.push_back(ijMap[{src_i, k}]);
-				arr.push_back(-1);
-				int nr = glp_add_rows(lp, 1);
+				desc.addCoef(ijMap[{src_i, k}], -1);
 				nCons++;
-				glp_set_mat_row(lp, nr, arr.size() - 1, ja.data(), arr.data());
-				glp_set_row_bnds(lp, nr, GLP_UP, 0.0, 0.0);
 			}
 
 			i++;
@@ -319,41 +309,27 @@ class GraphILP {
 
 	void addEdgePrec() {
 
-		int *ja = new int [1 + 2*numParts];
-		double *arr = new double [1 + 2*numVertices];
-		int nr = glp_add_rows(lp, numEdges); //numEdges rows constraints
 		int nCons = 0;
 
 		//add numEdges rows with limit to <= 0
-		int i = 0;
-		for(list<Edge>::iterator it = graph.edgeBegin(); it != graph.edgeEnd(); it++) {
-			glp_set_row_bnds(lp, nr + i, GLP_UP, 0.0, 0.0);
-			i++;
-		}
-
-
-		i = 0;
 		for(list<Edge>::iterator it = graph.edgeBegin(); it != graph.edgeEnd(); it++) {
 			//for src of edge do summation
 
 			uint32_t src = it->getSrcNodeID();
 			uint32_t dest = it->getDestNodeID();
 
+			desc.beginRow("", -LP_INF, 0.0);
 			//partition number * Xvertex_partition
 			for(int i = 0; i < numParts; i++) {
-				ja[i + 1] = (src*numParts) + i + 1;
-				arr[i + 1] = (i + 1) * 1;
+				desc.addCoef(ijMap[{src, i}], (i + 1) * 1);
 			}
 
 			//-partition number * Xvertex_partition
 			for(int i = 0; i < numParts; i++) {
-				ja[numParts + i + 1] = (dest*numParts) + i + 1;
-				arr[numParts + i + 1] = -(i + 1) * 1;
+				desc.addCoef(ijMap[{dest, i}], -(i + 1) * 1);
 			}
 
-			glp_set_mat_row(lp, nr + i, 2*numParts, ja, arr);
 			nCons++;
-			i++;
 		}
 
 		cout << "Number of precedence constraints added " << nCons << endl;
@@ -375,7 +351,7 @@ class GraphILP {
 			int srcPart = -1;
 			
 			for(int j = 0; j < numParts; j++) {
-				if(glp_mip_col_val(lp, ijMap[{src, j}]) == 1) {
+				if(colVal(ijMap[{src, j}]) == 1) {
 					srcPart = j;
 					break;
 				}
@@ -386,7 +362,7 @@ class GraphILP {
 			int destPart = -1;
 			
 			for(int j = 0; j < numParts; j++) {
-				if(glp_mip_col_val(lp, ijMap[{dest, j}]) == 1) {
+				if(colVal(ijMap[{dest, j}]) == 1) {
 					destPart = j;
 					break;
 				}
@@ -413,22 +389,19 @@ class GraphILP {
 	}
 	
 	void printProb() {
-		int ja[1024];
-		double arr[1024];
-		int nrows = glp_get_num_rows(lp);
+		int nrows = desc.getNumRows();
 		for(int i = 0; i < nrows; i++) {
-			int nelems = glp_get_mat_row(lp, i + 1, ja, arr);
-			for(int j = 0; j < nelems; j++) {
-				cout << arr[j + 1] << "*" << ja[j + 1] << " "; 
+			for(int k = desc.getRowBeg(i); k < desc.getRowEnd(i); k++) {
+				cout << desc.getVal(k) << "*" << desc.getInd(k) + 1 << " "; 
 			}
-			double ub = glp_get_row_ub(lp, i + 1);
+			double ub = desc.getRowHi(i);
 			cout << "\t" << ub;
 			cout << endl;
 		}
 
-		int ncols = glp_get_num_cols(lp);
+		int ncols = desc.getNumCols();
 		for(int  i = 0; i < ncols; i++) {
-			double coef = glp_get_obj_coef(lp, i + 1);
+			double coef = desc.getObj(i);
 			cout << coef << " ";
 		}
 		cout << endl;
@@ -436,6 +409,7 @@ class GraphILP {
 
 	bool solve() {
 		//solve equations
+		loadProb();
 		glp_set_obj_dir(lp, GLP_MIN);
 		glp_iocp parm;
 		glp_init_iocp(&parm);
@@ -452,8 +426,7 @@ class GraphILP {
 		cout << "Mappings ";
 		for(int i = 0; i < numVertices; i++) {
 			for(int j = 0; j < numParts; j++) {
-				//cout << glp_get_col_prim(lp, i * numParts + j + 1) << endl; 
-				if(glp_mip_col_val(lp, ijMap[{i, j}])) {
+				if(colVal(ijMap[{i, j}])) {
 					//cout << "Vertex id " << i  << " is mapped to " << j + 1 <<  endl;
 					cout << i <<  "|" << j << " ";
 					countVP++;
@@ -463,23 +436,13 @@ class GraphILP {
 		
 		cout << endl;
 
-		/*int ncols = glp_get_num_cols(lp);
-		cout << "Output vals of kl for each edge on newline in form part1:part2=bool present value" << endl;
-		for(auto klMap : this->klMapVec) {
-			for(int l = 0; l < numParts; l++) {
-				for(int k = l + 1; k < numParts; k++) {
-					cout << l << ":" << k << "=" << glp_mip_col_val(lp, klMap[{l, k}]) << " ";
-				}
-
-			}
-			cout << endl;
-		}*/
-		
 		return (countVP == numVertices); //return success if all vertices mapped to some partition
 
 	}
 
-	void write_LP(char *inpName, int size, int trans_limit) {
+	//write the model straight from its description, no glpk problem is built
+	//ext picks the format: .lp or .mps, optionally followed by .gz
+	void write_LP(char *inpName, int size, int trans_limit, string ext = ".lp") {
 	/*LP/Size/InputName_parts_translimit.lp*/
 		string fd("LP/");
 		string fname = fd;
@@ -499,24 +462,25 @@ class GraphILP {
 
 		fname = fname + to_string(trans_limit);
 		
-		string dotlp(".lp");
-		fname = fname + dotlp;
+		fname = fname + ext;
 
 		cout << fname << endl;
 		
-		glp_write_lp(lp, NULL, fname.c_str());
+		desc.write(fname);
 
 	}
-
 };
 
 /*Arguments required 
 	graph file name
 	Rsize
+	transaction limit
+  optional: model file extension (.lp default, .mps, either followed by .gz)
+            -fu <file> FU classes and their capacities, see FUClasses
 */
 int main(int argc, char **argv) {
 	
-	if(argc != 4) {
+	if(argc < 4) {
 		cout << "Too few arguments, 3 expected" << endl;
 		return -1;
 	}
@@ -531,7 +495,28 @@ int main(int argc, char **argv) {
 	
 	int size = atoi(argv[2]);
 	int trans_limit = atoi(argv[3]);
-	GraphILP *gp1 = new GraphILP("basic", gp, size, trans_limit);
+	string ext = ".lp";
+	FUClasses fu;
+	for(int a = 4; a < argc; a++) {
+		string opt = argv[a];
+		try {
+			if(opt == "-fu" && a + 1 < argc) {
+				if(!fu.load(argv[++a])) {
+					cout << "Cannot read FU classes " << argv[a] << endl;
+					return -1;
+				}
+			}
+			else if(opt[0] != '-') ext = opt;
+			else {
+				cout << "Unknown option " << opt << endl;
+				return -1;
+			}
+		} catch(string ex) {
+			cout << ex << endl;
+			return -1;
+		}
+	}
+	GraphILP *gp1 = new GraphILP("basic", gp, size, trans_limit, fu);
 
 	
 	int iterations = 10;
@@ -544,7 +529,7 @@ int main(int argc, char **argv) {
 		//gp1->addEdgePrec();
 		gp1->addCommCons2();
 		gp1->addTransCons();
-		gp1->write_LP(inpName, size, trans_limit); break;
+		gp1->write_LP(inpName, size, trans_limit, ext); break;
 		//gp1->printProb();
 		/*if(gp1->solve() == true) {
 			cout << "Converged at total number of partitions equal to " << gp1->getNumParts() << endl;
@@ -1,26 +1,74 @@
 #include "DFGPart.h"
 #include "DFGAnaly.h"
+#include "PartSched.h"
+#include "ScratchPad.h"
+#include "PerfModel.h"
+#include "PartCache.h"
+#include "PerfTrace.h"
 #include <vector>
 #include <stack>
 #include <list>
 #include <bits/stdc++.h>
 #include <string>
 
+static int solveTimed(DFGPart &dfgP, int map_size) {
+	PERF_SCOPE("solve");
+	return dfgP.partitionDFGVar(map_size);
+}
+
+//args: dotfilename, cgra size, routing percentage, optional -ports <memory ports per cycle> (default 4),
+//-perf <spec> to estimate the execution time (see parsePerfParams, fus and ports default to the map
+//size and -ports), -objective time to choose the splits by it (see PerfModel), -fu <file> for
+//FU class capacities (see FUClasses), -spad <slots> to cap the scratchpad (see ScratchPad),
+//-latency <file> for opcode latencies (see DFGAnaly), -pipeline to estimate double buffered
+//execution (see PerfModel) and -nocache to partition even if the result cache ($DFG_PART_CACHE or
+//.partcache) has an entry
 int main(int argc, char **argv) {
 	string fname = argv[1];
+	PerfTrace::setContext(fname);
 	try {
-		DAG graph(fname);
+		DAG graph;
+		{
+			PERF_SCOPE("dot_load");
+			graph = DAG(fname);
+		}
 		cout << "Created a DAG of fname " << fname << endl; 
 //		return 0;
 
+		int memPorts = 4;
+		string perfSpec;
+		bool timeObj = false;
+		partLimits lim; //FU classes and scratchpad cap, the capacity is the map size below
+		bool pipelined = false;
+		bool useCache = true;
+		LatencyTable latTable;
+		for(int a = 4; a < argc; a++) {
+			if(string(argv[a]) == "-pipeline") pipelined = true;
+			else if(string(argv[a]) == "-nocache") useCache = false;
+			else if(a + 1 == argc) break;
+			else if(string(argv[a]) == "-ports") memPorts = atoi(argv[++a]);
+			else if(string(argv[a]) == "-perf") perfSpec = argv[++a];
+			else if(string(argv[a]) == "-objective") timeObj = string(argv[++a]) == "time";
+			else if(string(argv[a]) == "-fu" && !lim.fu.load(argv[++a])) throw string("Cannot read FU classes ") + argv[a];
+			else if(string(argv[a]) == "-spad") lim.spSize = ScratchPad::parseCapacity(argv[++a]);
+			else if(string(argv[a]) == "-latency" && !DFGAnaly::readLatencyTable(argv[++a], latTable)) throw string("Cannot read latency table ") + argv[a];
+		}
+
 		DFGAnaly dfgA(graph);
-		DFGPart dfgP(graph);
-		double par = dfgA.getParallelism();
-		cout << "Parallelism in graph is " << par << endl;
-		uint32_t clen = dfgA.criticalPathLen();
-		cout << "Critical path length is " << clen << endl;
+		dfgA.setLatencies(latTable);
+		{
+			PERF_SCOPE("analysis");
+			double par = dfgA.getParallelism();
+			cout << "Parallelism in graph is " << par << endl;
+			uint32_t clen = dfgA.criticalPathLen();
+			cout << "Critical path length is " << clen << endl;
+			vector<int> slack;
+			dfgA.slack(slack);
+			long slackSum = accumulate(slack.begin(), slack.end(), 0L);
+			cout << "Vertices without slack " << count(slack.begin(), slack.end(), 0) << " average slack " << (slack.empty() ? 0.0 : double(slackSum) / slack.size()) << endl;
 
-		dfgA.getBasicProps();
+			dfgA.getBasicProps();
+		}
 
 		int cgra_size = atoi(argv[2]);
 		int percentage = atoi(argv[3]);
@@ -28,7 +76,54 @@ int main(int argc, char **argv) {
 
 		int map_size = cgra_size - routing_size;
 		cout << "Applicable Map size " << map_size << endl;
-		dfgP.partitionDFGVar(map_size);
+		lim.RSize = map_size;
+		DFGPart dfgP(graph, lim, latTable);
+		PerfModel *perf = NULL;
+		if(timeObj || perfSpec != "") {
+			perfParams base;
+			base.cgra = CGRAConfig{map_size, memPorts};
+			base.pipelined = pipelined;
+			base.latencies = latTable;
+			perf = new PerfModel(graph, parsePerfParams(perfSpec, base));
+		}
+		if(timeObj) {
+			dfgP.setObjective(perf);
+		}
+		PartCache cache;
+		vector<int> part;
+		int nparts = 0;
+		string tag = dfgA.latencyTag() == "" ? "dfgpart" : "dfgpart-lat" + dfgA.latencyTag(); //levels depend on the latencies
+		string fuTag = lim.fu.tag();
+		if(fuTag != "") {
+			tag += "-fu" + fuTag; //and the splits on the FU classes
+		}
+		if(lim.spSize < INT_MAX) {
+			tag += "-sp" + to_string(lim.spSize);
+		}
+		if(timeObj) {
+			tag += "-time" + perf->tag();
+		}
+		if(useCache && cache.lookup(graph, tag, lim, part, nparts)) {
+			cout << "Cached partitioning with " << nparts << " partitions" << endl;
+		}
+		else if((nparts = solveTimed(dfgP, map_size)) > 0) {
+			PERF_SCOPE("save");
+			part = dfgP.getAssign();
+			cache.store(graph, tag, lim, part, nparts);
+		}
+
+		//cycles of the partitions on the map_size FUs left after routing
+		if(nparts > 0) {
+			PERF_SCOPE("schedule");
+			PartSched sched(graph, CGRAConfig{map_size, memPorts}, latTable);
+			vector<int> start;
+			sched.printScheds(sched.schedule(part, nparts, start));
+			ScratchPad::printLiveness(ScratchPad(graph).liveness(part, nparts), nparts);
+			if(perf != NULL) {
+				perf->printEstimate(perf->estimate(part, nparts));
+			}
+		}
+		delete perf;
 	}catch(string er) {
 		cout << er << endl;
 	}
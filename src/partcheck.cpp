@@ -0,0 +1,104 @@
+#include <iostream>
+#include <string>
+#include "Graph.h"
+#include "PartEval.h"
+#include "PartResult.h"
+#include "ScratchPad.h"
+#include <bits/stdc++.h>
+
+using namespace std;
+
+/*Check a partition file against its DFG without any solver and report its cost.
+  args required: dotfilename, partition file
+  optional: -limits <size> <trans_limit> <load weight> to check against other limits than the file's
+            -fu <file> FU class capacities to check as well, see FUClasses
+            -spad <slots> scratchpad capacity to check instead of the file's, see ScratchPad
+            -pipeline check the read budget of double buffered execution, see PartEval; the
+                      default is the mode the file was written for
+  exit status is 0 only for a valid assignment*/
+int main(int argc, char **argv) {
+	if(argc < 3) {
+		cout << "Too few arguments, 2 expected" << endl;
+		return 2;
+	}
+	DAG gp;
+	try {
+		gp = DAG(argv[1]);
+	} catch(string ex) {
+		cout << ex << endl;
+		return 2;
+	}
+
+	PartResult res;
+	string err = readPartResult(argv[2], res);
+	if(err != "") {
+		cout << err << endl;
+		return 2;
+	}
+	partLimits lim; //scratchpad and pipelining from the file unless given, FU classes from the options
+	lim.pipelined = res.pipelined;
+	lim.spSize = res.spSize;
+	for(int a = 3; a < argc; a++) {
+		string opt = argv[a];
+		if(opt == "-fu" && a + 1 < argc) {
+			try {
+				if(!lim.fu.load(argv[++a])) {
+					cout << "Cannot read FU classes " << argv[a] << endl;
+					return 2;
+				}
+			} catch(string ex) {
+				cout << ex << endl;
+				return 2;
+			}
+		}
+		else if(opt == "-spad" && a + 1 < argc) {
+			try {
+				lim.spSize = ScratchPad::parseCapacity(argv[++a]);
+			} catch(string ex) {
+				cout << ex << endl;
+				return 2;
+			}
+		}
+		else if(opt == "-pipeline") {
+			lim.pipelined = true;
+		}
+		else if(opt == "-limits" && a + 3 < argc) {
+			res.RSize = atoi(argv[++a]);
+			res.TSize = atoi(argv[++a]);
+			res.loadWeight = atoi(argv[++a]);
+		}
+		else {
+			cout << "Unknown option " << opt << endl;
+			return 2;
+		}
+	}
+
+	if(res.graphHash != graphHash(gp)) {
+		cout << "Partition file was written for another graph (" << res.numVertices << " vertices, " << res.numEdges << " edges)" << endl;
+		return 1;
+	}
+
+	if(!res.fuTag.empty() && lim.fu.tag() != res.fuTag) {
+		cout << (lim.fu.limited() ? "FU classes differ from the ones the file was written for" :
+			"Partition file was written for FU classes " + res.fuTag + ", give -fu to check them") << endl;
+	}
+
+	lim.RSize = res.RSize;
+	lim.TSize = res.TSize;
+	lim.loadWeight = res.loadWeight;
+	PartEval eval(gp, lim);
+	vector<partCounts> counts;
+	err = eval.validate(res.part, res.numParts, counts);
+	if(err != "") {
+		cout << "Invalid: " << err << endl;
+		return 1;
+	}
+	eval.printCounts(counts);
+	long cost = eval.cost(counts);
+	cout << "Valid with partitions " << res.numParts << " cost " << cost;
+	if(res.cost >= 0 && res.cost != cost) {
+		cout << " (file reports " << res.cost << ")";
+	}
+	cout << endl;
+	return 0;
+}
@@ -0,0 +1,38 @@
+#include <iostream>
+#include <string>
+#include "Graph.h"
+#include "PartBnB.h"
+#include "PartSweep.h"
+#include <bits/stdc++.h>
+
+using namespace std;
+
+/*parameter sweep with the branch and bound partitioner, one single threaded job per core
+  args: <dot files|dirs|lists>... -R <sizes> -T <trans limits> [-L <load weights>]
+        [-jobs n] [-time secs] [-mem MB] [-out csv]*/
+int main(int argc, char **argv) {
+	PartSweep sweep;
+	if(!sweep.parseArgs(argc, argv, 1)) {
+		return -1;
+	}
+	sweep.run([](DAG &gp, int size, int trans_limit, int loadWt, SweepRecord &rec) {
+		partLimits lim;
+		lim.RSize = size;
+		lim.TSize = trans_limit;
+		lim.loadWeight = loadWt;
+		PartBnB bnb(gp, lim);
+		bnb.setThreads(1);
+		int numParts = ceil(float(gp.getNumNodes()) / float(size));
+		for(int i = 1; i <= 100; i++, numParts++) {
+			vector<int> part;
+			if(bnb.solve(numParts, part)) {
+				rec.numParts = numParts;
+				rec.iteration = i;
+				rec.objective = bnb.getBestCost();
+				return true;
+			}
+		}
+		return false;
+	});
+	return 0;
+}